@@ -85,6 +85,19 @@ HEADERS += \
     project/display.h \
     project/max2719.h \
     project/dotmatrix.h \
+    project/dotmatrix_gray.h \
+    project/dotmatrix_text.h \
+    project/dotmatrix_sched.h \
+    project/dotmatrix_anim.h \
+    project/anim_demo.h \
+    project/font.h \
+    project/spectrum.h \
+    project/window.h \
+    project/bands.h \
+    project/meter.h \
+    project/agc.h \
+    project/utils/log2fix.h \
+    project/utils/cycles.h \
     lib/cmsis/DSP_Lib/Include/arm_common_tables.h \
     lib/cmsis/DSP_Lib/Include/arm_const_structs.h \
     lib/cmsis/DSP_Lib/Include/arm_math.h \
@@ -150,6 +163,17 @@ SOURCES += \
     project/display.c \
     project/max2719.c \
     project/dotmatrix.c \
+    project/dotmatrix_gray.c \
+    project/dotmatrix_text.c \
+    project/dotmatrix_sched.c \
+    project/dotmatrix_anim.c \
+    project/anim_demo.c \
+    project/font.c \
+    project/spectrum.c \
+    project/window.c \
+    project/bands.c \
+    project/meter.c \
+    project/agc.c \
     lib/cmsis/DSP_Lib/Source/BasicMathFunctions/arm_abs_f32.c \
     lib/cmsis/DSP_Lib/Source/BasicMathFunctions/arm_abs_q15.c \
     lib/cmsis/DSP_Lib/Source/BasicMathFunctions/arm_abs_q31.c \
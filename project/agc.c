@@ -0,0 +1,94 @@
+#include "agc.h"
+#include "com/debug.h"
+#include "meter.h"
+#include "utils/log2fix.h"
+
+
+static void compute_steps(Agc *agc)
+{
+	agc->k_attack = meter_coef(agc->params.attack_ms, agc->frame_us);
+	agc->k_release = meter_coef(agc->params.release_ms, agc->frame_us);
+}
+
+
+void agc_init(Agc *agc, const Agc_Params *params, uint32_t frame_us)
+{
+	agc->params = *params;
+	agc->frame_us = frame_us;
+	agc->env = params->floor_db * LOG2FIX_DB;
+	agc->bottom = agc->env;
+
+	compute_steps(agc);
+}
+
+
+void agc_set_frame_time(Agc *agc, uint32_t frame_us)
+{
+	agc->frame_us = frame_us;
+	compute_steps(agc);
+}
+
+
+void agc_set_params(Agc *agc, const Agc_Params *params)
+{
+	agc->params = *params;
+	compute_steps(agc);
+}
+
+
+void agc_process(Agc *agc, const uint16_t *levels, uint16_t *heights, uint32_t n, uint32_t height_px)
+{
+	const Agc_Params *p = &agc->params;
+	const int32_t ref = log2fix(AGC_FULL_SCALE);
+
+	// loudest band
+	uint16_t max = 0;
+	for (uint32_t b = 0; b < n; b++) {
+		if (levels[b] > max) max = levels[b];
+	}
+
+	const int32_t loud = log2fix(max) - ref;
+
+	// the difference is below 2^22 (< 130 dB), x 0.16 fits in 64 bits
+	const int32_t diff = loud - agc->env;
+	const uint16_t k = (diff > 0) ? agc->k_attack : agc->k_release;
+	agc->env += (int32_t)(((int64_t)diff * k) >> 16);
+
+	// scale: top above the envelope, but the bottom not under the floor
+	const int32_t range = p->range_db * LOG2FIX_DB;
+	const int32_t noise = p->floor_db * LOG2FIX_DB;
+
+	int32_t bottom = agc->env + p->headroom_db * LOG2FIX_DB - range;
+	if (bottom < noise) bottom = noise;
+	agc->bottom = bottom;
+
+	// log units -> 8.8 px
+	const int32_t full = (int32_t)(height_px << 8);
+	const uint32_t per_unit = (uint32_t)(((uint64_t)full << 16) / (uint32_t)MAX(range, 1)); // 16.16
+
+	for (uint32_t b = 0; b < n; b++) {
+		int32_t d = log2fix(levels[b]) - ref - bottom;
+
+		if (d <= 0) {
+			heights[b] = 0;
+		} else if (d >= range) {
+			heights[b] = (uint16_t)full;
+		} else {
+			heights[b] = (uint16_t)(((uint64_t)d * per_unit) >> 16);
+		}
+	}
+}
+
+
+void agc_report(Agc *agc)
+{
+	const Agc_Params *p = &agc->params;
+
+	dbg("AGC: floor %"PRId16" dB, headroom %u dB, range %u dB, attack %"PRIu16" ms, release %"PRIu16" ms",
+		p->floor_db, p->headroom_db, p->range_db, p->attack_ms, p->release_ms);
+
+	// 16.16 log2 -> tenths of dB
+	dbg("  envelope %"PRId32" dBFS/10, scale %"PRId32"..%"PRId32" dBFS/10",
+		agc->env * 10 / LOG2FIX_DB, agc->bottom * 10 / LOG2FIX_DB,
+		(agc->bottom + p->range_db * LOG2FIX_DB) * 10 / LOG2FIX_DB);
+}
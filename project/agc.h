@@ -0,0 +1,68 @@
+#ifndef AGC_H
+#define AGC_H
+
+/**
+ * Automatic gain control and dB scaling of the band levels
+ *
+ * Levels are converted to dBFS (log2fix, no float). An envelope follows
+ * the loudest band - fast up, slowly down - and the display scale is
+ * placed under it: the top of the bars is headroom_db above the
+ * envelope, the bottom range_db below the top. The scale never goes
+ * below the noise floor (floor_db is the lowest possible bottom), so
+ * silence shows nothing instead of amplified noise.
+ */
+
+#include "main.h"
+
+/** Band level of a full-scale tone, 0 dBFS */
+#define AGC_FULL_SCALE 16384
+
+/** Tunables */
+typedef struct {
+	int16_t floor_db; /*!< Noise floor, dBFS (negative) */
+	uint8_t headroom_db; /*!< Top of the scale above the envelope */
+	uint8_t range_db; /*!< Span of the bar height */
+	uint16_t attack_ms; /*!< Envelope rise time constant */
+	uint16_t release_ms; /*!< Envelope fall time constant */
+} Agc_Params;
+
+typedef struct {
+	Agc_Params params; /*!< Tunables */
+	uint32_t frame_us; /*!< Frame period the coefficients are computed for */
+	int32_t env; /*!< Envelope, dBFS in 16.16 log2 units */
+	int32_t bottom; /*!< Scale bottom of the last frame, same units */
+
+	// --- per-frame steps ---
+	uint16_t k_attack; /*!< Part of the difference taken per frame, 0.16 */
+	uint16_t k_release; /*!< Same, falling */
+} Agc;
+
+
+/**
+ * @brief Set up the AGC
+ * @param agc : instance (caller-owned)
+ * @param params : tunables, copied
+ * @param frame_us : frame period, us
+ */
+void agc_init(Agc *agc, const Agc_Params *params, uint32_t frame_us);
+
+/** Set the frame period (when the capture rate changes) */
+void agc_set_frame_time(Agc *agc, uint32_t frame_us);
+
+/** Change the tunables */
+void agc_set_params(Agc *agc, const Agc_Params *params);
+
+/**
+ * @brief Update the envelope and map band levels to bar heights
+ * @param agc : instance
+ * @param levels : band levels (AGC_FULL_SCALE = 0 dBFS)
+ * @param heights : output, 8.8 pixels
+ * @param n : number of bands
+ * @param height_px : full bar height, pixels
+ */
+void agc_process(Agc *agc, const uint16_t *levels, uint16_t *heights, uint32_t n, uint32_t height_px);
+
+/** Print the tunables and the current scale to debug output */
+void agc_report(Agc *agc);
+
+#endif // AGC_H
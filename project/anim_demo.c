@@ -0,0 +1,86 @@
+// Demo animation, 24 frames, 2x2 modules - coded as by tools/anim2c.php
+// (growing square rings, then a rotating line)
+
+#include "anim_demo.h"
+
+static const uint8_t anim_demo_data[] = {
+	// frame 0 (key)
+	0x01, 0x81, 0x01, 0x80, 0x01, 0x97, 0x01, 0x80, 0x01, 0x81,
+	// frame 1
+	0x00, 0x81, 0x01, 0xC0, 0x03, 0x81, 0x01, 0xC0, 0x03, 0x8F, 0x01, 0xC0, 0x03, 0x81, 0x01, 0xC0,
+	0x03, 0x81,
+	// frame 2
+	0x00, 0x81, 0x01, 0x60, 0x06, 0x81, 0x01, 0xE0, 0x07, 0x81, 0x01, 0xE0, 0x07, 0x87, 0x01, 0xE0,
+	0x07, 0x81, 0x01, 0xE0, 0x07, 0x81, 0x01, 0x60, 0x06, 0x81,
+	// frame 3
+	0x00, 0x81, 0x01, 0x30, 0x0C, 0x81, 0x01, 0x30, 0x0C, 0x81, 0x01, 0xF0, 0x0F, 0x81, 0x03, 0xF0,
+	0x0F, 0xF0, 0x0F, 0x81, 0x01, 0xF0, 0x0F, 0x81, 0x01, 0x30, 0x0C, 0x81, 0x01, 0x30, 0x0C, 0x81,
+	// frame 4
+	0x00, 0x81, 0x01, 0x18, 0x18, 0x81, 0x01, 0x18, 0x18, 0x81, 0x0B, 0x18, 0x18, 0xF8, 0x1F, 0xF8,
+	0x1F, 0xF8, 0x1F, 0xF8, 0x1F, 0x18, 0x18, 0x81, 0x01, 0x18, 0x18, 0x81, 0x01, 0x18, 0x18, 0x81,
+	// frame 5
+	0x00, 0x81, 0x01, 0x0C, 0x30, 0x81, 0x13, 0x0C, 0x30, 0xFC, 0x3F, 0x0C, 0x30, 0xFC, 0x3F, 0x0C,
+	0x30, 0x0C, 0x30, 0xFC, 0x3F, 0x0C, 0x30, 0xFC, 0x3F, 0x0C, 0x30, 0x81, 0x01, 0x0C, 0x30, 0x81,
+	// frame 6
+	0x00, 0x81, 0x1B, 0x06, 0x60, 0xFE, 0x7F, 0x06, 0x60, 0xFE, 0x7F, 0x06, 0x60, 0x06, 0x60, 0x06,
+	0x60, 0x06, 0x60, 0x06, 0x60, 0x06, 0x60, 0xFE, 0x7F, 0x06, 0x60, 0xFE, 0x7F, 0x06, 0x60, 0x81,
+	// frame 7
+	0x00, 0x1F, 0xFF, 0xFF, 0x03, 0xC0, 0xFF, 0xFF, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0,
+	0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0x03, 0xC0, 0xFF, 0xFF, 0x03, 0xC0,
+	0xFF, 0xFF,
+	// frame 8 (key)
+	0x01, 0x81, 0x01, 0xFF, 0xFF, 0x97, 0x01, 0xFF, 0xFF, 0x81,
+	// frame 9
+	0x00, 0x81, 0x01, 0x7F, 0xC0, 0x82, 0x00, 0xF0, 0x8F, 0x00, 0x0F, 0x82, 0x01, 0x03, 0xFE, 0x81,
+	// frame 10 (key)
+	0x01, 0x82, 0x00, 0x07, 0x82, 0x00, 0x1C, 0x82, 0x00, 0xF0, 0x82, 0x01, 0x80, 0x01, 0x82, 0x00,
+	0x0F, 0x82, 0x00, 0x38, 0x82, 0x00, 0xE0, 0x82,
+	// frame 11
+	0x00, 0x82, 0x00, 0x04, 0x82, 0x01, 0x1A, 0x01, 0x81, 0x01, 0xE8, 0x03, 0x81, 0x01, 0xB0, 0x0D,
+	0x81, 0x01, 0xC0, 0x17, 0x81, 0x01, 0x80, 0x58, 0x82, 0x00, 0x20, 0x82,
+	// frame 12
+	0x00, 0x00, 0x01, 0x81, 0x01, 0x02, 0x02, 0x81, 0x01, 0x04, 0x05, 0x81, 0x01, 0x1C, 0x0B, 0x81,
+	0x01, 0x38, 0x1C, 0x81, 0x01, 0xD0, 0x38, 0x81, 0x01, 0xA0, 0x20, 0x81, 0x01, 0x40, 0x40, 0x81,
+	0x00, 0x80,
+	// frame 13
+	0x00, 0x00, 0x0D, 0x82, 0x00, 0x0A, 0x81, 0x01, 0x01, 0x14, 0x81, 0x01, 0x06, 0x38, 0x81, 0x01,
+	0x0C, 0x30, 0x81, 0x01, 0x1C, 0x60, 0x81, 0x01, 0x28, 0x80, 0x81, 0x00, 0x50, 0x82, 0x00, 0xB0,
+	// frame 14
+	0x00, 0x00, 0x3C, 0x82, 0x00, 0x28, 0x81, 0x01, 0x02, 0x30, 0x81, 0x01, 0x01, 0x50, 0x81, 0x01,
+	0x06, 0x60, 0x81, 0x01, 0x0A, 0x80, 0x81, 0x01, 0x0C, 0x40, 0x81, 0x00, 0x14, 0x82, 0x00, 0x3C,
+	// frame 15
+	0x00, 0x04, 0x70, 0x00, 0x80, 0x00, 0x60, 0x82, 0x00, 0xE0, 0x81, 0x01, 0x02, 0xA0, 0x81, 0x01,
+	0x03, 0xC0, 0x81, 0x01, 0x05, 0x40, 0x81, 0x00, 0x07, 0x82, 0x04, 0x06, 0x00, 0x01, 0x00, 0x0E,
+	// frame 16
+	0x00, 0x01, 0xC0, 0x01, 0x81, 0x0A, 0xC0, 0x01, 0x80, 0x00, 0x40, 0x01, 0x80, 0x00, 0x40, 0x01,
+	0x80, 0x81, 0x0A, 0x01, 0x80, 0x02, 0x00, 0x01, 0x80, 0x02, 0x00, 0x01, 0x80, 0x03, 0x81, 0x01,
+	0x80, 0x03,
+	// frame 17
+	0x00, 0x01, 0x80, 0x03, 0x81, 0x17, 0x80, 0x03, 0x00, 0x01, 0x80, 0x02, 0x00, 0x01, 0x80, 0x02,
+	0x00, 0x01, 0x80, 0x00, 0x40, 0x01, 0x80, 0x00, 0x40, 0x01, 0x80, 0x00, 0xC0, 0x01, 0x81, 0x01,
+	0xC0, 0x01,
+	// frame 18
+	0x00, 0x80, 0x04, 0x0E, 0x00, 0x01, 0x00, 0x06, 0x82, 0x01, 0x07, 0x40, 0x81, 0x01, 0x05, 0xC0,
+	0x81, 0x01, 0x03, 0xA0, 0x81, 0x01, 0x02, 0xE0, 0x82, 0x04, 0x60, 0x00, 0x80, 0x00, 0x70, 0x80,
+	// frame 19
+	0x00, 0x80, 0x00, 0x3C, 0x82, 0x01, 0x14, 0x40, 0x81, 0x01, 0x0C, 0x80, 0x81, 0x01, 0x0A, 0x60,
+	0x81, 0x01, 0x06, 0x50, 0x81, 0x01, 0x01, 0x30, 0x81, 0x01, 0x02, 0x28, 0x82, 0x00, 0x3C, 0x80,
+	// frame 20
+	0x00, 0x80, 0x00, 0xB0, 0x82, 0x01, 0x50, 0x80, 0x81, 0x01, 0x28, 0x60, 0x81, 0x01, 0x1C, 0x30,
+	0x81, 0x01, 0x0C, 0x38, 0x81, 0x01, 0x06, 0x14, 0x81, 0x01, 0x01, 0x0A, 0x82, 0x00, 0x0D, 0x80,
+	// frame 21 (key)
+	0x01, 0x81, 0x00, 0xC0, 0x82, 0x00, 0x60, 0x81, 0x01, 0x80, 0x18, 0x81, 0x01, 0xC0, 0x0C, 0x81,
+	0x01, 0x30, 0x03, 0x81, 0x01, 0x18, 0x01, 0x81, 0x00, 0x06, 0x82, 0x00, 0x03, 0x81,
+	// frame 22 (key)
+	0x01, 0x81, 0x00, 0xE0, 0x82, 0x00, 0x38, 0x82, 0x00, 0x0F, 0x82, 0x00, 0x01, 0x81, 0x00, 0x80,
+	0x82, 0x00, 0xF0, 0x82, 0x00, 0x1C, 0x82, 0x00, 0x07, 0x81,
+	// frame 23 (key)
+	0x01, 0x81, 0x01, 0xFC, 0x01, 0x81, 0x00, 0x0F, 0x91, 0x00, 0xF0, 0x81, 0x01, 0x80, 0x3F, 0x81,
+};
+
+const DotMatrix_Anim anim_demo = {
+	.frame_len = 32,
+	.frames = 24,
+	.frame_ms = 60,
+	.data = anim_demo_data,
+};
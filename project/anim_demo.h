@@ -0,0 +1,9 @@
+#ifndef ANIM_DEMO_H
+#define ANIM_DEMO_H
+
+#include "dotmatrix_anim.h"
+
+/** Built-in demo for a 2x2 module matrix, see anim_demo.c */
+extern const DotMatrix_Anim anim_demo;
+
+#endif // ANIM_DEMO_H
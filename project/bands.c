@@ -0,0 +1,158 @@
+#include "bands.h"
+#include "malloc_safe.h"
+#include "com/debug.h"
+#include <math.h>
+
+
+/** Mel scale */
+static inline float hz_to_mel(float f)
+{
+	return 2595.0f * log10f(1 + f / 700.0f);
+}
+
+
+static inline float mel_to_hz(float m)
+{
+	return 700.0f * (powf(10, m / 2595.0f) - 1);
+}
+
+
+float bands_edge(Bands_Scale scale, uint32_t edge, uint32_t count, float f_min, float f_max)
+{
+	const float t = (float)edge / count;
+
+	switch (scale) {
+		case BANDS_OCTAVE: {
+			// 1/n octave grid edges 1 kHz * 2^((j - 0.5) / n), the last one <= f_max
+			const float n = MAX(1, floorf(count / log2f(f_max / f_min)));
+			const float j_end = floorf(n * log2f(f_max / 1000.0f) + 0.5f);
+			return 1000.0f * powf(2, (j_end - count + edge - 0.5f) / n);
+		}
+
+		case BANDS_MEL: {
+			const float m_min = hz_to_mel(f_min);
+			return mel_to_hz(m_min + (hz_to_mel(f_max) - m_min) * t);
+		}
+
+		case BANDS_LOG:
+		default:
+			return f_min * powf(f_max / f_min, t);
+	}
+}
+
+
+Bands* bands_init(Bands_Scale scale, uint32_t count, uint32_t fft_len, uint32_t rate, uint32_t f_min, uint32_t f_max)
+{
+	const uint32_t bin_count = fft_len / 2;
+	const float bin_hz = (float)rate / fft_len;
+
+	if (f_max > rate / 2) f_max = rate / 2;
+	if (f_min < 1) f_min = 1;
+	if (f_max <= f_min) f_max = f_min * 2;
+
+	Bands *bd = calloc_s(1, sizeof(Bands));
+	bd->scale = scale;
+	bd->count = count;
+	bd->band = calloc_s(bin_count, sizeof(uint8_t));
+	bd->weight = calloc_s(bin_count, sizeof(uint16_t));
+	bd->edges = calloc_s(count + 1, sizeof(uint32_t));
+	bd->acc = calloc_s(count + 1, sizeof(uint32_t));
+
+	// Edges in bins. Bin k spans k-0.5 .. k+0.5; bin 0 (DC) is left out.
+	float *e = malloc_s((count + 1) * sizeof(float));
+
+	for (uint32_t b = 0; b <= count; b++) {
+		float x = bands_edge(scale, b, count, f_min, f_max) / bin_hz;
+
+		if (b == 0) {
+			x = MAX(0.5f, roundf(x + 0.5f) - 0.5f); // whole bins at the ends
+		} else {
+			x = MAX(x, e[b - 1] + 1); // at least a bin wide
+		}
+
+		if (b == count) x = roundf(x + 0.5f) - 0.5f;
+		if (x > bin_count - 0.5f) x = bin_count - 0.5f;
+
+		e[b] = x;
+		bd->edges[b] = (uint32_t)(x * bin_hz + 0.5f);
+	}
+
+	bd->first_bin = (uint32_t)(e[0] + 0.5f);
+	bd->last_bin = (uint32_t)(e[count] + 0.5f);
+
+	// at most one edge falls in a bin
+	uint32_t b = 0;
+	for (uint32_t k = bd->first_bin; k < bd->last_bin; k++) {
+		const float lo = k - 0.5f;
+		while (b < count - 1 && e[b + 1] <= lo) b++;
+
+		bd->band[k] = (uint8_t)b;
+
+		const float hi = e[b + 1];
+		if (b < count - 1 && hi < lo + 1) {
+			bd->weight[k] = (uint16_t)((hi - lo) * 256 + 0.5f);
+		} else {
+			bd->weight[k] = 256;
+		}
+	}
+
+	free(e);
+	return bd;
+}
+
+
+size_t bands_mem_size(uint32_t count, uint32_t fft_len)
+{
+	// struct, band, weight, edges, acc + 8 bytes of malloc overhead each
+	return sizeof(Bands) + fft_len / 2 * (sizeof(uint8_t) + sizeof(uint16_t))
+		   + (count + 1) * (sizeof(uint32_t) + sizeof(uint32_t)) + 5 * 8;
+}
+
+
+void bands_free(Bands *bd)
+{
+	if (bd == NULL) return;
+
+	free(bd->band);
+	free(bd->weight);
+	free(bd->edges);
+	free(bd->acc);
+	free(bd);
+}
+
+
+void bands_reduce(Bands *bd, const uint16_t *bins, uint16_t *out)
+{
+	uint32_t *acc = bd->acc;
+	memset(acc, 0, (bd->count + 1) * sizeof(uint32_t));
+
+	for (uint32_t k = bd->first_bin; k < bd->last_bin; k++) {
+		const uint32_t m = bins[k];
+		const uint32_t part = (m * bd->weight[k]) >> 8;
+		const uint32_t b = bd->band[k];
+
+		acc[b] += part;
+		acc[b + 1] += m - part;
+	}
+
+	for (uint32_t b = 0; b < bd->count; b++) {
+		out[b] = (uint16_t)MIN(acc[b], 0xFFFF);
+	}
+}
+
+
+void bands_report(Bands *bd)
+{
+	static const char *names[BANDS_SCALE_COUNT] = {
+		[BANDS_LOG] = "log",
+		[BANDS_OCTAVE] = "octave",
+		[BANDS_MEL] = "mel",
+	};
+
+	dbg("Bands: %"PRIu32" %s, bins %"PRIu32"..%"PRIu32,
+		bd->count, names[bd->scale], bd->first_bin, bd->last_bin - 1);
+
+	for (uint32_t b = 0; b < bd->count; b++) {
+		dbg("  %2"PRIu32": %5"PRIu32" .. %5"PRIu32" Hz", b, bd->edges[b], bd->edges[b + 1]);
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef BANDS_H
+#define BANDS_H
+
+/**
+ * FFT bins -> display bands
+ *
+ * The band edges are spaced on a logarithmic, octave or mel scale.
+ * A table built once for the FFT length and sample rate gives the band
+ * of each bin and the part of the bin that falls in it (a bin split
+ * by an edge feeds two bands), so reducing a spectrum is one pass
+ * over the bins.
+ *
+ * Bands are at least one bin wide - at the low end, where the scale
+ * is finer than the bins, the bands are one bin each.
+ *
+ * A band value is the weighted sum of its bins' magnitudes: a tone
+ * reads the same (about its amplitude) in a narrow or a wide band.
+ */
+
+#include "main.h"
+
+typedef enum {
+	BANDS_LOG = 0, /*!< Edges in a geometric series from f_min to f_max */
+	BANDS_OCTAVE, /*!< 1/n octave bands (ISO grid, 1 kHz centered) ending at f_max; n fits the count in the range */
+	BANDS_MEL, /*!< Edges evenly spaced in mels */
+	BANDS_SCALE_COUNT,
+} Bands_Scale;
+
+typedef struct {
+	Bands_Scale scale; /*!< Band spacing */
+	uint32_t count; /*!< Number of bands */
+	uint32_t first_bin; /*!< First bin used */
+	uint32_t last_bin; /*!< Last bin used + 1 */
+	uint8_t *band; /*!< Band of each bin; if split, the lower one */
+	uint16_t *weight; /*!< Part of each bin in band[k], 8.8; the rest is in band[k] + 1 */
+	uint32_t *edges; /*!< Band edges, Hz (count + 1) */
+	uint32_t *acc; /*!< Accumulators (count + 1) */
+} Bands;
+
+
+/**
+ * @brief Frequency of a band edge
+ * @param scale : band spacing
+ * @param edge : edge index, 0 .. count
+ * @param count : number of bands
+ * @param f_min : lower edge of the first band, Hz
+ * @param f_max : upper edge of the last band, Hz
+ * @return frequency, Hz
+ */
+float bands_edge(Bands_Scale scale, uint32_t edge, uint32_t count, float f_min, float f_max);
+
+/**
+ * @brief Build the bin -> band table
+ *
+ * Bands beyond the last bin (more bands than bins) stay empty.
+ *
+ * @param scale : band spacing
+ * @param count : number of bands, up to 255
+ * @param fft_len : FFT length (fft_len / 2 bins)
+ * @param rate : sample rate, Hz
+ * @param f_min : lower edge of the first band, Hz
+ * @param f_max : upper edge of the last band, Hz (clipped to rate / 2)
+ * @return the table
+ */
+Bands* bands_init(Bands_Scale scale, uint32_t count, uint32_t fft_len, uint32_t rate, uint32_t f_min, uint32_t f_max);
+
+/** Heap needed by bands_init(), bytes */
+size_t bands_mem_size(uint32_t count, uint32_t fft_len);
+
+/** Release the table */
+void bands_free(Bands *bd);
+
+/**
+ * @brief Reduce bin magnitudes to band values
+ * @param bd : table
+ * @param bins : bin magnitudes, fft_len / 2
+ * @param out : band values, count (saturated to 16 bits)
+ */
+void bands_reduce(Bands *bd, const uint16_t *bins, uint16_t *out);
+
+/** Print the band edges to debug output */
+void bands_report(Bands *bd);
+
+#endif // BANDS_H
@@ -7,8 +7,8 @@
 #include "main.h"
 #include <sbmp.h>
 
-#define DG_REQUEST_RAW 40 // request raw vector. Sample count [u16], Frequency [u32]
-#define DG_REQUEST_FFT 41 // request fft vector. Sample count [u16], Frequency [u32]. Result - count/2 bins. Count must be 2^n, 16..2048
+#define DG_REQUEST_RAW 40 // request raw vector. Sample count [u16], Frequency [u32]. Result - count ADC samples [u16]
+#define DG_REQUEST_FFT 41 // request fft vector. Sample count [u16], Frequency [u32]. Result - count/2 bins [u16, |X|/N in 2.14]. Count must be 2^n, 16..2048
 #define DG_REQUEST_STORE_REF 42 // calculate signal signature & store for comparing
 #define DG_REQUEST_COMPARE_REF 43
 // wifi status & control
@@ -16,6 +16,7 @@
 #define DG_WPS_START 45 // start WPS
 #define DG_WIFI_STATUS 46 // WiFi status report
 #define DG_REQUEST_STM_VERSION 47 // Get acquisition module firmware version
+#define DG_REQUEST_FAILED 48 // response to a request that can't be met (bad parameters, busy, not enough RAM). Payload: request type [u8]
 
 
 extern SBMP_Endpoint *dlnk_ep;
@@ -3,28 +3,195 @@
 #include "malloc_safe.h"
 #include "com/debug.h"
 
+
+// ---- Bit-matrix kernels ----
+//
+// A module's 8 digit bytes packed in a word: byte = digit (y), bit = x.
+
+
+/**
+ * @brief Transpose an 8x8 bit matrix
+ *
+ * Byte i of the word holds row i, bit j column j.
+ * The result has bit i of byte j set where the input had bit j of byte i.
+ */
+static inline uint64_t transpose8x8(uint64_t x)
+{
+	uint64_t t;
+	t = 0x0F0F0F0F00000000ULL & (x ^ (x << 28));
+	x ^= t ^ (t >> 28);
+	t = 0x3333000033330000ULL & (x ^ (x << 14));
+	x ^= t ^ (t >> 14);
+	t = 0x5500550055005500ULL & (x ^ (x << 7));
+	x ^= t ^ (t >> 7);
+	return x;
+}
+
+
+/** Mirror left-right (reverse bits in each byte) */
+static inline uint64_t flip_h8x8(uint64_t x)
+{
+	x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+	x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	return x;
+}
+
+
+/** Mirror top-bottom (reverse the bytes) */
+static inline uint64_t flip_v8x8(uint64_t x)
+{
+	return __builtin_bswap64(x);
+}
+
+
+static uint64_t orient_0(uint64_t x)
+{
+	return x;
+}
+
+
+static uint64_t orient_90(uint64_t x)
+{
+	return flip_v8x8(transpose8x8(x));
+}
+
+
+static uint64_t orient_180(uint64_t x)
+{
+	return flip_v8x8(flip_h8x8(x));
+}
+
+
+static uint64_t orient_270(uint64_t x)
+{
+	return flip_h8x8(transpose8x8(x));
+}
+
+
+/** Logical -> physical module image, indexed by DotMatrix_Orientation */
+static uint64_t (* const orient_kernel[])(uint64_t) = {
+	[DMTX_ROT_0] = orient_0,
+	[DMTX_ROT_90] = orient_90,
+	[DMTX_ROT_180] = orient_180,
+	[DMTX_ROT_270] = orient_270,
+};
+
+
+const uint8_t* dmtx_physical(DotMatrix_Cfg* dmtx, const uint8_t *src)
+{
+	const uint32_t row_len = dmtx->modules;
+
+	if (dmtx->phys == NULL) return src;
+
+	for (uint32_t m = 0; m < row_len; m++) {
+		const uint8_t *mp = src + m;
+		uint8_t *dst = dmtx->phys + m;
+
+		uint64_t x = 0;
+		for (uint32_t d = 0; d < 8; d++) {
+			x |= (uint64_t)mp[d * row_len] << (d * 8);
+		}
+
+		x = orient_kernel[dmtx->orient[m]](x);
+
+		for (uint32_t d = 0; d < 8; d++) {
+			dst[d * row_len] = (uint8_t)(x >> (d * 8));
+		}
+	}
+
+	return dmtx->phys;
+}
+
 DotMatrix_Cfg* dmtx_init(DotMatrix_Init *init)
 {
 	DotMatrix_Cfg *dmtx = calloc_s(1, sizeof(DotMatrix_Cfg));
 
-	dmtx->drv.SPIx = init->SPIx;
-	dmtx->drv.CS_GPIOx = init->CS_GPIOx;
-	dmtx->drv.CS_PINx = init->CS_PINx;
-	dmtx->drv.chain_len = init->cols * init->rows;
 	dmtx->cols = init->cols;
 	dmtx->rows = init->rows;
+	dmtx->modules = init->cols * init->rows;
 
-	dmtx->screen = calloc_s(init->cols * init->rows * 8, 1); // 8 bytes per driver
+	uint32_t chain_count = 0;
 
-	max2719_cmd_all(&dmtx->drv, MAX2719_CMD_DECODE_MODE, 0x00); // no decode
-	max2719_cmd_all(&dmtx->drv, MAX2719_CMD_SCAN_LIMIT, 0x07); // scan all 8
-	max2719_cmd_all(&dmtx->drv, MAX2719_CMD_SHUTDOWN, 0x01); // not shutdown
-	max2719_cmd_all(&dmtx->drv, MAX2719_CMD_DISPLAY_TEST, 0x00); // not test
-	max2719_cmd_all(&dmtx->drv, MAX2719_CMD_INTENSITY, 0x07); // half intensity
+	if (init->chains != NULL) {
+		chain_count = MIN(init->chain_count, DMTX_MAX_CHAINS);
 
-	// clear
-	for (uint8_t i = 0; i < 8; i++) {
-		max2719_cmd_all(&dmtx->drv, MAX2719_CMD_DIGIT0+i, 0);
+		// the chains' slices of the screen must cover it exactly
+		uint32_t chain_rows = 0;
+		for (uint32_t c = 0; c < chain_count; c++) {
+			chain_rows += init->chains[c].rows;
+		}
+
+		if (chain_count == 0 || chain_rows != init->rows) {
+			error("Chains cover %"PRIu32" rows of %"PRIu32", using one chain", chain_rows, init->rows);
+			chain_count = 0;
+		}
+	}
+
+	if (chain_count == 0) {
+		const bool fallback = (init->chains != NULL && init->chain_count > 0);
+
+		dmtx->chain_count = 1;
+		dmtx->drv[0].SPIx = fallback ? init->chains[0].SPIx : init->SPIx;
+		dmtx->drv[0].CS_GPIOx = fallback ? init->chains[0].CS_GPIOx : init->CS_GPIOx;
+		dmtx->drv[0].CS_PINx = fallback ? init->chains[0].CS_PINx : init->CS_PINx;
+		dmtx->drv[0].chain_len = dmtx->modules;
+	} else {
+		dmtx->chain_count = chain_count;
+
+		uint32_t first = 0;
+		for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+			const DotMatrix_Chain *ch = &init->chains[c];
+
+			dmtx->drv[c].SPIx = ch->SPIx;
+			dmtx->drv[c].CS_GPIOx = ch->CS_GPIOx;
+			dmtx->drv[c].CS_PINx = ch->CS_PINx;
+			dmtx->drv[c].chain_len = ch->rows * init->cols;
+			dmtx->chain_first[c] = first;
+			first += dmtx->drv[c].chain_len;
+		}
+	}
+
+	dmtx->screen = calloc_s(dmtx->modules * 8, 1); // 8 bytes per driver
+	dmtx->shadow = calloc_s(dmtx->modules * 8, 1); // matches the cleared display
+	dmtx->changed = calloc_s(dmtx->modules, 1);
+
+	if (init->double_buffer) {
+		dmtx->front = calloc_s(dmtx->modules * 8, 1);
+	} else {
+		dmtx->front = dmtx->screen;
+	}
+
+	if (init->orientation != NULL) {
+		for (uint32_t i = 0; i < dmtx->modules; i++) {
+			if (init->orientation[i] == DMTX_ROT_0) continue;
+
+			// some modules are rotated, keep a map and a physical frame
+			dmtx->orient = calloc_s(dmtx->modules, 1);
+			memcpy(dmtx->orient, init->orientation, dmtx->modules);
+			dmtx->phys = calloc_s(dmtx->modules * 8, 1);
+			break;
+		}
+	}
+
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		MAX2719_Cfg *drv = &dmtx->drv[c];
+
+		// chains read their slice of the full-width digit rows
+		drv->stride = dmtx->modules;
+		drv->scrub = true;
+		max2719_init(drv);
+
+		max2719_cmd_all(drv, MAX2719_CMD_DECODE_MODE, 0x00); // no decode
+		max2719_cmd_all(drv, MAX2719_CMD_SCAN_LIMIT, 0x07); // scan all 8
+		max2719_cmd_all(drv, MAX2719_CMD_SHUTDOWN, 0x01); // not shutdown
+		max2719_cmd_all(drv, MAX2719_CMD_DISPLAY_TEST, 0x00); // not test
+		max2719_cmd_all(drv, MAX2719_CMD_INTENSITY, 0x07); // half intensity
+
+		// clear
+		for (uint8_t i = 0; i < 8; i++) {
+			max2719_cmd_all(drv, MAX2719_CMD_DIGIT0+i, 0);
+		}
 	}
 
 	return dmtx;
@@ -32,25 +199,119 @@ DotMatrix_Cfg* dmtx_init(DotMatrix_Init *init)
 
 void dmtx_show(DotMatrix_Cfg* dmtx)
 {
+	const uint32_t row_len = dmtx->modules;
+	const bool single = (dmtx->front == dmtx->screen);
+	const uint8_t *frame = dmtx->front;
+	uint8_t sent = 0;
+	uint32_t sent_bytes = 0;
+
+	if (single) {
+		dmtx->front_dirty |= dmtx->dirty;
+		dmtx->dirty = 0;
+	}
+
+	if (dmtx->phys != NULL && dmtx->front_dirty) {
+		// a logical digit may map to any digit of a rotated module
+		frame = dmtx_physical(dmtx, dmtx->front);
+		dmtx->front_dirty = 0xFF;
+	}
+
+	// find the changed digits of each module
 	for (uint8_t i = 0; i < 8; i++) {
-		// show each digit's array in turn
-		max2719_cmd_all_data(&dmtx->drv, MAX2719_CMD_DIGIT0+i, dmtx->screen + (i * dmtx->drv.chain_len));
+		if (!(dmtx->front_dirty & (1 << i))) continue;
+
+		const uint8_t *row = frame + (i * row_len);
+		uint8_t *shadow_row = dmtx->shadow + (i * row_len);
+		const bool stale = (dmtx->stale & (1 << i));
+
+		for (uint32_t m = 0; m < row_len; m++) {
+			// the digit may have been changed back
+			if (!stale && row[m] == shadow_row[m]) continue;
+
+			shadow_row[m] = row[m];
+			dmtx->changed[m] |= 1 << i;
+			sent |= 1 << i;
+		}
+	}
+
+	dmtx->stale &= ~dmtx->front_dirty;
+	dmtx->front_dirty = 0;
+
+	// the drawing buffer may now differ from what's displayed
+	if (!single) {
+		dmtx->dirty |= sent;
+	}
+
+	// the streams are built right away, DMA does the rest -
+	// the next chain is built while the previous one is being sent
+	dmtx->sent_rows = 0;
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		const uint32_t first = dmtx->chain_first[c];
+		const uint32_t rows = max2719_send_sparse(&dmtx->drv[c], frame + first, dmtx->changed + first);
+
+		dmtx->sent_rows += rows;
+		sent_bytes += rows * dmtx->drv[c].chain_len * 2; // 2 bytes per driver per row
+	}
+
+	// scrub rows can make it more than a full frame
+	const uint32_t full_bytes = row_len * 8 * 2;
+	dmtx->saved_bytes = (sent_bytes < full_bytes) ? full_bytes - sent_bytes : 0;
+	dmtx->saved_bytes_total += dmtx->saved_bytes;
+}
+
+void dmtx_swap(DotMatrix_Cfg* dmtx)
+{
+	if (dmtx->front == dmtx->screen) return;
+
+	uint8_t *p = dmtx->front;
+	dmtx->front = dmtx->screen;
+	dmtx->screen = p;
+
+	uint8_t d = dmtx->front_dirty;
+	dmtx->front_dirty = dmtx->dirty;
+	dmtx->dirty = d;
+}
+
+void dmtx_invalidate(DotMatrix_Cfg* dmtx)
+{
+	dmtx->stale = 0xFF;
+	dmtx->dirty = 0xFF;
+	dmtx->front_dirty = 0xFF;
+}
+
+bool dmtx_busy(DotMatrix_Cfg* dmtx)
+{
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		if (max2719_busy(&dmtx->drv[c])) return true;
+	}
+	return false;
+}
+
+void dmtx_wait(DotMatrix_Cfg* dmtx)
+{
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		max2719_wait(&dmtx->drv[c]);
 	}
 }
 
 void dmtx_clear(DotMatrix_Cfg* dmtx)
 {
-	memset(dmtx->screen, 0, dmtx->drv.chain_len*8);
+	memset(dmtx->screen, 0, dmtx->modules*8);
+	dmtx->dirty = 0xFF;
 }
 
 void dmtx_intensity(DotMatrix_Cfg* dmtx, uint8_t intensity)
 {
-	max2719_cmd_all(&dmtx->drv, MAX2719_CMD_INTENSITY, intensity & 0x0F);
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		max2719_cmd_all(&dmtx->drv[c], MAX2719_CMD_INTENSITY, intensity & 0x0F);
+	}
 }
 
 void dmtx_blank(DotMatrix_Cfg* dmtx, bool blank)
 {
-	max2719_cmd_all(&dmtx->drv, MAX2719_CMD_SHUTDOWN, blank & 0x01);
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		max2719_cmd_all(&dmtx->drv[c], MAX2719_CMD_SHUTDOWN, blank & 0x01);
+	}
 }
 
 /**
@@ -73,7 +334,7 @@ static uint8_t* cell_ptr(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, uint8_t *xd)
 	uint32_t digit = y & 7;
 	cell_x += ((uint32_t)y >> 3) * dmtx->cols;
 
-	uint32_t cell_idx = (digit * dmtx->drv.chain_len) + cell_x;
+	uint32_t cell_idx = (digit * dmtx->modules) + cell_x;
 
 	return &dmtx->screen[cell_idx];
 }
@@ -96,6 +357,7 @@ void dmtx_toggle(DotMatrix_Cfg* dmtx, int32_t x, int32_t y)
 	if (cell == NULL) return;
 
 	*cell ^= 1 << xd;
+	dmtx->dirty |= 1 << (y & 7);
 }
 
 
@@ -105,9 +367,411 @@ void dmtx_set(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, bool bit)
 	uint8_t *cell = cell_ptr(dmtx, x, y, &xd);
 	if (cell == NULL) return;
 
+	uint8_t old = *cell;
+
+	if (bit) {
+		*cell |= 1 << xd;
+	} else {
+		*cell &= ~(1 << xd);
+	}
+
+	if (*cell != old) {
+		dmtx->dirty |= 1 << (y & 7);
+	}
+}
+
+
+// ---- Span operations ----
+//
+// One screen row is a contiguous run of 'cols' bytes (all modules
+// in the row of modules, for one digit), LSB being the leftmost pixel.
+// This makes any horizontal span a little-endian bit string, handled
+// here 24 pixels at a time in a 32-bit word.
+
+
+/** Pointer to the first byte of a screen row */
+static inline uint8_t* row_ptr(DotMatrix_Cfg* dmtx, uint32_t y)
+{
+	return &dmtx->screen[(y & 7) * dmtx->modules + (y >> 3) * dmtx->cols];
+}
+
+
+/** Load up to 4 bytes as a little-endian word */
+static inline uint32_t load_le(const uint8_t *p, uint32_t nbytes)
+{
+	uint32_t w = 0;
+	for (uint32_t i = 0; i < nbytes; i++) {
+		w |= (uint32_t)p[i] << (i * 8);
+	}
+	return w;
+}
+
+
+/** Store up to 4 bytes of a little-endian word */
+static inline void store_le(uint8_t *p, uint32_t w, uint32_t nbytes)
+{
+	for (uint32_t i = 0; i < nbytes; i++) {
+		p[i] = (uint8_t)(w >> (i * 8));
+	}
+}
+
+
+/** Combine bits into a word, only where the mask is set */
+static inline uint32_t apply_op(uint32_t dst, uint32_t bits, uint32_t mask, DotMatrix_Op op)
+{
+	switch (op) {
+		case DMTX_OP_COPY: return (dst & ~mask) | (bits & mask);
+		case DMTX_OP_OR: return dst | (bits & mask);
+		case DMTX_OP_AND: return dst & (bits | ~mask);
+		case DMTX_OP_XOR: return dst ^ (bits & mask);
+		case DMTX_OP_CLEAR: return dst & ~(bits & mask);
+	}
+	return dst;
+}
+
+
+/**
+ * @brief Apply a bit string to a screen row
+ * @param row : row pointer
+ * @param x : first pixel (already clipped)
+ * @param w : pixel count (already clipped)
+ * @param src : source bits, LSB first; NULL for all ones
+ * @param sx : bit offset in src
+ * @param op : raster op
+ */
+static void span_op(uint8_t *row, uint32_t x, uint32_t w, const uint8_t *src, uint32_t sx, DotMatrix_Op op)
+{
+	const uint32_t shift = x & 7;
+	uint8_t *dp = row + (x >> 3);
+
+	while (w > 0) {
+		const uint32_t n = MIN(w, 24);
+		const uint32_t ones = (1UL << n) - 1;
+
+		uint32_t bits = ones;
+		if (src != NULL) {
+			const uint32_t sh = sx & 7;
+			bits = (load_le(src + (sx >> 3), (sh + n + 7) >> 3) >> sh) & ones;
+		}
+
+		const uint32_t nbytes = (shift + n + 7) >> 3;
+		const uint32_t word = load_le(dp, nbytes);
+		store_le(dp, apply_op(word, bits << shift, ones << shift, op), nbytes);
+
+		dp += 3;
+		sx += n;
+		w -= n;
+	}
+}
+
+
+/** Clip a span to 0..limit. Returns false if nothing is left. */
+static inline bool clip_span(int32_t *start, int32_t *len, int32_t limit, int32_t *skipped)
+{
+	*skipped = 0;
+	if (*start < 0) {
+		*skipped = -*start;
+		*len += *start;
+		*start = 0;
+	}
+	if (*start + *len > limit) *len = limit - *start;
+	return *len > 0;
+}
+
+
+/** Mark rows y..y+h-1 as dirty */
+static inline void mark_rows(DotMatrix_Cfg* dmtx, uint32_t y, uint32_t h)
+{
+	if (h >= 8) {
+		dmtx->dirty = 0xFF;
+	} else {
+		uint32_t m = ((1 << h) - 1) << (y & 7);
+		dmtx->dirty |= (uint8_t)(m | (m >> 8));
+	}
+}
+
+
+void dmtx_blit(DotMatrix_Cfg* dmtx, const uint8_t *src, int32_t w, int32_t h, int32_t x, int32_t y, DotMatrix_Op op)
+{
+	const uint32_t src_stride = (w + 7) >> 3;
+	int32_t skip_x, skip_y;
+
+	if (!clip_span(&x, &w, dmtx->cols*8, &skip_x)) return;
+	if (!clip_span(&y, &h, dmtx->rows*8, &skip_y)) return;
+
+	src += skip_y * src_stride;
+
+	for (int32_t i = 0; i < h; i++) {
+		span_op(row_ptr(dmtx, y + i), x, w, src, skip_x, op);
+		src += src_stride;
+	}
+
+	mark_rows(dmtx, y, h);
+}
+
+
+void dmtx_fill_rect(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t w, int32_t h, DotMatrix_Op op)
+{
+	int32_t skip;
+
+	if (!clip_span(&x, &w, dmtx->cols*8, &skip)) return;
+	if (!clip_span(&y, &h, dmtx->rows*8, &skip)) return;
+
+	for (int32_t i = 0; i < h; i++) {
+		span_op(row_ptr(dmtx, y + i), x, w, NULL, 0, op);
+	}
+
+	mark_rows(dmtx, y, h);
+}
+
+
+void dmtx_hline(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t w, DotMatrix_Op op)
+{
+	dmtx_fill_rect(dmtx, x, y, w, 1, op);
+}
+
+
+void dmtx_vline(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t h, DotMatrix_Op op)
+{
+	int32_t skip;
+
+	if (x < 0 || (uint32_t)x >= dmtx->cols*8) return;
+	if (!clip_span(&y, &h, dmtx->rows*8, &skip)) return;
+
+	const uint32_t mask = 1 << (x & 7);
+	const int32_t digit_step = dmtx->modules;
+	const int32_t module_step = dmtx->cols - 7 * digit_step; // from digit 7 to digit 0 of the next module
+
+	uint8_t *p = row_ptr(dmtx, y) + (x >> 3);
+	uint32_t yd = y & 7;
+
+	for (int32_t i = 0; i < h; i++) {
+		*p = (uint8_t)apply_op(*p, mask, mask, op);
+
+		if (yd == 7) {
+			p += module_step;
+			yd = 0;
+		} else {
+			p += digit_step;
+			yd++;
+		}
+	}
+
+	mark_rows(dmtx, y, h);
+}
+
+
+// ---- Bar graph ----
+
+
+/** Lit rows 0..n-1 of a module, n = 0..8 */
+static const uint8_t fill_mask[9] = {
+	0x00, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF
+};
+
+
+/** Rows lo..hi-1 of a module at module row offset 'base' */
+static inline uint8_t range_mask(int32_t lo, int32_t hi, int32_t base)
+{
+	lo -= base;
+	hi -= base;
+	if (lo < 0) lo = 0;
+	if (hi > 8) hi = 8;
+	if (hi <= lo) return 0;
+	return fill_mask[hi] & ~fill_mask[lo];
+}
+
+
+void dmtx_bars(DotMatrix_Cfg* dmtx, const uint8_t *heights, uint32_t n, DotMatrix_BarStyle style)
+{
+	const int32_t height = dmtx->rows * 8;
+	const uint32_t row_len = dmtx->modules;
+
+	if (n > dmtx->cols * 8) n = dmtx->cols * 8;
+
+	// rows lo..hi-1 lit in each column
+	int32_t lo[8], hi[8];
+
+	for (uint32_t mx = 0; mx * 8 < n; mx++) {
+		const uint32_t ncol = MIN(8, n - mx * 8);
+		const uint8_t colmask = fill_mask[ncol];
+
+		for (uint32_t c = 0; c < 8; c++) {
+			int32_t h = (c < ncol) ? heights[mx * 8 + c] : 0;
+			if (h > height) h = height;
+
+			switch (style) {
+				case DMTX_BARS_FILL:
+					lo[c] = 0;
+					hi[c] = h;
+					break;
+
+				case DMTX_BARS_PEAK:
+					lo[c] = h - 1;
+					hi[c] = h;
+					break;
+
+				case DMTX_BARS_MIRROR:
+					lo[c] = (height - h) / 2;
+					hi[c] = lo[c] + h;
+					break;
+			}
+		}
+
+		for (uint32_t my = 0; my < dmtx->rows; my++) {
+			// one byte per column, bit = row; transposed to one byte per digit
+			uint64_t cols = 0;
+			for (uint32_t c = 0; c < ncol; c++) {
+				cols |= (uint64_t)range_mask(lo[c], hi[c], my * 8) << (c * 8);
+			}
+
+			const uint64_t digits = transpose8x8(cols);
+
+			uint8_t *p = dmtx->screen + my * dmtx->cols + mx;
+			for (uint32_t d = 0; d < 8; d++) {
+				*p = (*p & ~colmask) | ((uint8_t)(digits >> (d * 8)) & colmask);
+				p += row_len;
+			}
+		}
+	}
+
+	if (n > 0) {
+		dmtx->dirty = 0xFF;
+	}
+}
+
+
+void dmtx_set_column(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, uint8_t bits)
+{
+	if (x < 0 || (uint32_t)x >= dmtx->cols*8) return;
+
+	const uint8_t mask = 1 << (x & 7);
+	const int32_t height = dmtx->rows * 8;
+
+	for (int32_t i = 0; i < 8; i++, bits >>= 1) {
+		if (y + i < 0 || y + i >= height) continue;
+
+		uint8_t *p = row_ptr(dmtx, y + i) + (x >> 3);
+		if (bits & 1) {
+			*p |= mask;
+		} else {
+			*p &= ~mask;
+		}
+	}
+
+	dmtx->dirty = 0xFF;
+}
+
+
+void dmtx_shift_left(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	int32_t skip;
+
+	if (!clip_span(&x, &w, dmtx->cols*8, &skip)) return;
+	if (!clip_span(&y, &h, dmtx->rows*8, &skip)) return;
+
+	for (int32_t i = 0; i < h; i++) {
+		uint8_t *row = row_ptr(dmtx, y + i);
+
+		// reading ahead of the write position, so it can be done in place
+		if (w > 1) span_op(row, x, w - 1, row, x + 1, DMTX_OP_COPY);
+		span_op(row, x + w - 1, 1, NULL, 0, DMTX_OP_CLEAR);
+	}
+
+	mark_rows(dmtx, y, h);
+}
+
+
+// ---- Virtual canvas ----
+
+
+DotMatrix_Canvas* dmtx_canvas_init(uint32_t width, uint32_t height)
+{
+	DotMatrix_Canvas *cv = calloc_s(1, sizeof(DotMatrix_Canvas));
+
+	cv->width = width;
+	cv->bands = (height + 7) / 8;
+	cv->offset = 0;
+	cv->columns = calloc_s(cv->width * cv->bands, 1);
+
+	return cv;
+}
+
+
+void dmtx_canvas_clear(DotMatrix_Canvas *cv)
+{
+	memset(cv->columns, 0, cv->width * cv->bands);
+}
+
+
+/** Column byte of a pixel; NULL if outside */
+static uint8_t* canvas_ptr(DotMatrix_Canvas *cv, int32_t x, int32_t y)
+{
+	if (x < 0 || y < 0) return NULL;
+	if ((uint32_t)x >= cv->width || (uint32_t)y >= cv->bands * 8) return NULL;
+
+	return &cv->columns[((uint32_t)y >> 3) * cv->width + (uint32_t)x];
+}
+
+
+void dmtx_canvas_set(DotMatrix_Canvas *cv, int32_t x, int32_t y, bool bit)
+{
+	uint8_t *p = canvas_ptr(cv, x, y);
+	if (p == NULL) return;
+
 	if (bit) {
-		*cell |= bit << xd;
+		*p |= 1 << (y & 7);
 	} else {
-		*cell &= ~(bit << xd);
+		*p &= ~(1 << (y & 7));
 	}
 }
+
+
+bool dmtx_canvas_get(DotMatrix_Canvas *cv, int32_t x, int32_t y)
+{
+	uint8_t *p = canvas_ptr(cv, x, y);
+	if (p == NULL) return 0;
+
+	return (bool)(*p & (1 << (y & 7)));
+}
+
+
+void dmtx_canvas_scroll(DotMatrix_Canvas *cv, int32_t dx)
+{
+	int32_t off = ((int32_t)cv->offset + dx) % (int32_t)cv->width;
+	if (off < 0) off += cv->width;
+
+	cv->offset = (uint32_t)off;
+}
+
+
+void dmtx_canvas_render(DotMatrix_Cfg* dmtx, const DotMatrix_Canvas *cv)
+{
+	const uint32_t row_len = dmtx->modules;
+
+	for (uint32_t my = 0; my < dmtx->rows; my++) {
+		const uint8_t *band = (my < cv->bands) ? cv->columns + my * cv->width : NULL;
+		uint32_t x = cv->offset;
+
+		for (uint32_t mx = 0; mx < dmtx->cols; mx++) {
+			// one byte per column, bit = row; transposed to one byte per digit
+			uint64_t cols = 0;
+
+			if (band != NULL) {
+				for (uint32_t c = 0; c < 8; c++) {
+					cols |= (uint64_t)band[x] << (c * 8);
+					if (++x == cv->width) x = 0;
+				}
+			}
+
+			const uint64_t digits = transpose8x8(cols);
+
+			uint8_t *p = dmtx->screen + my * dmtx->cols + mx;
+			for (uint32_t d = 0; d < 8; d++) {
+				p[d * row_len] = (uint8_t)(digits >> (d * 8));
+			}
+		}
+	}
+
+	dmtx->dirty = 0xFF;
+}
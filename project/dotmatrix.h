@@ -4,30 +4,135 @@
 #include "main.h"
 #include "max2719.h"
 
+/** Raster operations for the blit and fill functions */
+typedef enum {
+	DMTX_OP_COPY, /*!< dst = src */
+	DMTX_OP_OR, /*!< dst |= src */
+	DMTX_OP_AND, /*!< dst &= src */
+	DMTX_OP_XOR, /*!< dst ^= src */
+	DMTX_OP_CLEAR, /*!< dst &= ~src */
+} DotMatrix_Op;
+
+/** Module mounting orientation, corrected when sending */
+typedef enum {
+	DMTX_ROT_0 = 0, /*!< Upright */
+	DMTX_ROT_90, /*!< Rotated 90 degrees clockwise */
+	DMTX_ROT_180, /*!< Upside down */
+	DMTX_ROT_270, /*!< Rotated 90 degrees counter-clockwise */
+} DotMatrix_Orientation;
+
+/** Bar graph styles for dmtx_bars() */
+typedef enum {
+	DMTX_BARS_FILL, /*!< Solid bars growing from y = 0 */
+	DMTX_BARS_PEAK, /*!< Only the top dot of each bar */
+	DMTX_BARS_MIRROR, /*!< Solid bars centered vertically */
+} DotMatrix_BarStyle;
+
+/** Max number of driver chains (one per SPI with DMA) */
+#define DMTX_MAX_CHAINS 2
+
 typedef struct {
-	MAX2719_Cfg drv;
+	MAX2719_Cfg drv[DMTX_MAX_CHAINS]; /*!< Driver chains, each covering a band of module rows */
+	uint32_t chain_first[DMTX_MAX_CHAINS]; /*!< Index of the first module of each chain */
+	uint32_t chain_count; /*!< Number of chains used */
+	uint32_t modules; /*!< Total number of drivers (length of a digit row in the screen array) */
 	uint8_t *screen; /*!< Screen array, organized as series of [all #1 digits], [all #2 digits] ... */
+	uint8_t *front; /*!< Displayed screen array - the same as screen if not double-buffered */
+	uint8_t *shadow; /*!< Last transmitted screen, same layout (physical, if some modules are rotated) */
+	uint8_t *orient; /*!< Orientation of each module, NULL if all are upright */
+	uint8_t *phys; /*!< Front buffer with rotated modules corrected, NULL if all are upright */
+	uint8_t *changed; /*!< Changed digits of each module, scratch for dmtx_show() */
+	uint8_t dirty; /*!< Digits of screen possibly differing from the shadow, bit 0 = DIGIT0 */
+	uint8_t front_dirty; /*!< Digits of front possibly differing from the shadow */
+	uint8_t stale; /*!< Digits of the shadow not known to match the display */
 	uint32_t cols; /*!< Number of drivers horizontally */
 	uint32_t rows; /*!< Number of drivers vertically */
+	uint32_t sent_rows; /*!< Rows (latches) sent by the last dmtx_show(), summed over chains */
+	uint32_t saved_bytes; /*!< SPI bytes skipped by the last dmtx_show() */
+	uint32_t saved_bytes_total; /*!< SPI bytes skipped since init */
 } DotMatrix_Cfg;
 
+/**
+ * Virtual canvas, larger than the screen, with a viewport
+ *
+ * Stored as packed columns - one byte per column per 8-row band,
+ * bit 0 = top row of the band (the font's format). The viewport
+ * starts at column `offset` and wraps around the canvas width.
+ */
 typedef struct {
-	SPI_TypeDef *SPIx; /*!< SPI iface used by this instance */
+	uint8_t *columns; /*!< Band by band, [band * width + x] */
+	uint32_t width; /*!< Width in pixels */
+	uint32_t bands; /*!< Height in 8-row bands */
+	uint32_t offset; /*!< Canvas column shown at the left screen edge */
+} DotMatrix_Canvas;
+
+/** A driver chain, see DotMatrix_Init */
+typedef struct {
+	SPI_TypeDef *SPIx; /*!< SPI iface of the chain, must differ for each chain */
 	GPIO_TypeDef *CS_GPIOx; /*!< Chip select GPIO port */
 	uint16_t CS_PINx; /*!< Chip select pin mask */
+	uint32_t rows; /*!< Number of module rows driven by the chain */
+} DotMatrix_Chain;
+
+typedef struct {
+	SPI_TypeDef *SPIx; /*!< SPI iface used by this instance (if chains is NULL) */
+	GPIO_TypeDef *CS_GPIOx; /*!< Chip select GPIO port (if chains is NULL) */
+	uint16_t CS_PINx; /*!< Chip select pin mask (if chains is NULL) */
+	const DotMatrix_Chain *chains; /*!< Chains from the top down, their rows adding up to `rows`; NULL = one chain with all rows */
+	uint32_t chain_count; /*!< Number of chains, max DMTX_MAX_CHAINS */
 	uint32_t cols; /*!< Number of drivers horizontally */
 	uint32_t rows; /*!< Number of drivers vertically */
+	bool double_buffer; /*!< Allocate a separate front buffer, see dmtx_swap() */
+	const uint8_t *orientation; /*!< DotMatrix_Orientation of each module (row by row), NULL if all are upright */
 } DotMatrix_Init;
 
 
 DotMatrix_Cfg* dmtx_init(DotMatrix_Init *init);
 
 /**
- * @brief Display the whole screen array
+ * @brief Display the front screen array
+ *
+ * Only digits changed since the last show are sent, packed
+ * so that each latch updates one changed digit in every module
+ * (see max2719_build_sparse()).
+ * Returns as soon as the transfer is started; the screen
+ * array can be modified right away. Chains on different
+ * SPIs are sent concurrently.
+ *
  * @param dmtx : driver struct
  */
 void dmtx_show(DotMatrix_Cfg* dmtx);
 
+/**
+ * @brief Exchange the drawing and front buffer (double-buffered mode only)
+ *
+ * Only pointers are swapped; the new drawing buffer holds
+ * the frame before the last one.
+ *
+ * @param dmtx : driver struct
+ */
+void dmtx_swap(DotMatrix_Cfg* dmtx);
+
+/**
+ * @brief Correct module orientation in a screen-layout array
+ *
+ * The result is stored in the phys buffer.
+ *
+ * @param dmtx : driver struct
+ * @param src : array in the screen layout
+ * @return the corrected array (src itself if all modules are upright)
+ */
+const uint8_t* dmtx_physical(DotMatrix_Cfg* dmtx, const uint8_t *src);
+
+/** Mark the whole screen for re-sending (eg. after writing the screen array directly) */
+void dmtx_invalidate(DotMatrix_Cfg* dmtx);
+
+/** Check if the screen is still being sent */
+bool dmtx_busy(DotMatrix_Cfg* dmtx);
+
+/** Wait for the screen transfer to finish */
+void dmtx_wait(DotMatrix_Cfg* dmtx);
+
 /** Set intensity 0-16 */
 void dmtx_intensity(DotMatrix_Cfg* dmtx, uint8_t intensity);
 
@@ -52,4 +157,91 @@ void dmtx_toggle(DotMatrix_Cfg* dmtx, int32_t x, int32_t y);
 /** Clear the screen (not showing) */
 void dmtx_clear(DotMatrix_Cfg* dmtx);
 
+/**
+ * @brief Draw a bitmap
+ *
+ * The bitmap is stored by rows, each row padded to whole bytes,
+ * LSB being the leftmost pixel. It is clipped to the screen.
+ *
+ * @param dmtx : driver struct
+ * @param src : bitmap data
+ * @param w : bitmap width
+ * @param h : bitmap height
+ * @param x : left edge on the screen
+ * @param y : top edge on the screen
+ * @param op : raster op
+ */
+void dmtx_blit(DotMatrix_Cfg* dmtx, const uint8_t *src, int32_t w, int32_t h, int32_t x, int32_t y, DotMatrix_Op op);
+
+/**
+ * @brief Fill a rectangle
+ *
+ * The rectangle acts as a source of all ones:
+ * COPY and OR light the pixels, CLEAR turns them off, XOR toggles them.
+ */
+void dmtx_fill_rect(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t w, int32_t h, DotMatrix_Op op);
+
+/** Horizontal line of w pixels, see dmtx_fill_rect() */
+void dmtx_hline(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t w, DotMatrix_Op op);
+
+/** Vertical line of h pixels, see dmtx_fill_rect() */
+void dmtx_vline(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t h, DotMatrix_Op op);
+
+/**
+ * @brief Write 8 pixels of a column
+ * @param dmtx : driver struct
+ * @param x : column
+ * @param y : top pixel
+ * @param bits : pixel values, bit 0 at y
+ */
+void dmtx_set_column(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, uint8_t bits);
+
+/** Shift a rectangle one pixel to the left, clearing its right edge */
+void dmtx_shift_left(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, int32_t w, int32_t h);
+
+/**
+ * @brief Draw a bar graph, one bar per column
+ *
+ * Columns 0..n-1 are overwritten over the full screen height,
+ * 8 columns at a time (one bit-matrix transpose per module).
+ *
+ * @param dmtx : driver struct
+ * @param heights : bar heights in pixels
+ * @param n : number of bars (clipped to the screen width)
+ * @param style : bar style
+ */
+void dmtx_bars(DotMatrix_Cfg* dmtx, const uint8_t *heights, uint32_t n, DotMatrix_BarStyle style);
+
+/**
+ * @brief Allocate a virtual canvas
+ * @param width : width in pixels
+ * @param height : height in pixels (rounded up to 8)
+ * @return the canvas, cleared, viewport at 0
+ */
+DotMatrix_Canvas* dmtx_canvas_init(uint32_t width, uint32_t height);
+
+/** Clear the canvas */
+void dmtx_canvas_clear(DotMatrix_Canvas *cv);
+
+/** Set a canvas pixel */
+void dmtx_canvas_set(DotMatrix_Canvas *cv, int32_t x, int32_t y, bool bit);
+
+/** Get a canvas pixel */
+bool dmtx_canvas_get(DotMatrix_Canvas *cv, int32_t x, int32_t y);
+
+/** Move the viewport right by dx columns (negative = left), wrapping around */
+void dmtx_canvas_scroll(DotMatrix_Canvas *cv, int32_t dx);
+
+/**
+ * @brief Copy the viewport to the screen array (not showing)
+ *
+ * One 8x8 transpose per module, whatever the canvas holds -
+ * scrolling costs the same as drawing a static frame.
+ * Bands below the canvas are cleared.
+ *
+ * @param dmtx : driver struct
+ * @param cv : canvas
+ */
+void dmtx_canvas_render(DotMatrix_Cfg* dmtx, const DotMatrix_Canvas *cv);
+
 #endif // MATRIXDSP_H
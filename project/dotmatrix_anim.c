@@ -0,0 +1,139 @@
+#include "dotmatrix_anim.h"
+#include "utils/cycles.h"
+#include "com/debug.h"
+
+
+const uint8_t* dmtx_anim_decode(const uint8_t *frame, uint8_t *buf, uint32_t len, uint8_t *digits, uint32_t row_len)
+{
+	uint32_t pos = 0;
+	uint8_t changed = 0;
+
+	if (*frame++ & DMTX_ANIM_KEY) {
+		memset(buf, 0, len);
+		changed = 0xFF;
+	}
+
+	while (pos < len) {
+		const uint8_t tok = *frame++;
+		const uint32_t n = (tok & 0x7F) + 1u;
+
+		if (tok & DMTX_ANIM_SKIP) {
+			pos += n;
+			continue;
+		}
+
+		// XOR the literal in, noting the digit rows it spans
+		for (uint32_t d = pos / row_len; d <= (pos + n - 1) / row_len; d++) {
+			changed |= 1 << d;
+		}
+
+		for (uint32_t i = 0; i < n; i++) {
+			buf[pos++] ^= *frame++;
+		}
+	}
+
+	*digits = changed;
+	return frame;
+}
+
+
+bool dmtx_anim_step(DotMatrix_AnimPlayer *pl)
+{
+	DotMatrix_Cfg *dmtx = pl->dmtx;
+	const DotMatrix_Anim *anim = pl->anim;
+	const uint32_t len = dmtx->modules * 8;
+
+	if (pl->frame >= anim->frames) {
+		if (!pl->loop) return false;
+
+		pl->frame = 0;
+		pl->next = anim->data;
+	}
+
+	uint32_t start = cyc_now();
+
+	// the screen buffer holds an older frame
+	if (dmtx->front != dmtx->screen) {
+		memcpy(dmtx->screen, dmtx->front, len);
+		dmtx->dirty |= dmtx->front_dirty;
+	}
+
+	uint8_t digits;
+	pl->next = dmtx_anim_decode(pl->next, dmtx->screen, len, &digits, dmtx->modules);
+	dmtx->dirty |= digits;
+	pl->frame++;
+
+	pl->decode_cycles = cyc_elapsed(start);
+	if (pl->decode_cycles > pl->decode_cycles_max) {
+		pl->decode_cycles_max = pl->decode_cycles;
+	}
+
+	return true;
+}
+
+
+static void anim_task(void *arg)
+{
+	DotMatrix_AnimPlayer *pl = arg;
+
+	if (!dmtx_anim_step(pl)) {
+		dmtx_anim_stop(pl);
+		return;
+	}
+
+	dmtx_swap(pl->dmtx);
+	dmtx_show(pl->dmtx);
+}
+
+
+void dmtx_anim_start(DotMatrix_AnimPlayer *pl, DotMatrix_Cfg* dmtx, const DotMatrix_Anim *anim, bool loop)
+{
+	dmtx_anim_stop(pl);
+
+	pl->dmtx = dmtx;
+	pl->anim = anim;
+	pl->next = anim->data;
+	pl->frame = 0;
+	pl->loop = loop;
+	pl->decode_cycles_max = 0;
+
+	if (anim->frame_len != dmtx->modules * 8) {
+		error("Animation frame %"PRIu32" B, screen %"PRIu32" B", anim->frame_len, dmtx->modules * 8);
+		return;
+	}
+
+	pl->task = add_periodic_task(anim_task, pl, anim->frame_ms, true);
+}
+
+
+void dmtx_anim_stop(DotMatrix_AnimPlayer *pl)
+{
+	if (pl->task != PID_NONE) {
+		remove_periodic_task(pl->task);
+		pl->task = PID_NONE;
+	}
+}
+
+
+bool dmtx_anim_playing(DotMatrix_AnimPlayer *pl)
+{
+	return pl->task != PID_NONE;
+}
+
+
+void dmtx_anim_report(DotMatrix_AnimPlayer *pl)
+{
+	if (pl->anim == NULL) {
+		dbg("Anim: nothing played");
+		return;
+	}
+
+	const uint32_t cyc_us = F_CPU / 1000000;
+
+	dbg("Anim: frame %"PRIu32" of %"PRIu32", %"PRIu32" ms, %s",
+		(uint32_t)pl->frame, (uint32_t)pl->anim->frames, (uint32_t)pl->anim->frame_ms,
+		dmtx_anim_playing(pl) ? "playing" : "stopped");
+	dbg("  decode %"PRIu32" cyc (%"PRIu32" us), max %"PRIu32" cyc (%"PRIu32" us)",
+		pl->decode_cycles, pl->decode_cycles / cyc_us,
+		pl->decode_cycles_max, pl->decode_cycles_max / cyc_us);
+}
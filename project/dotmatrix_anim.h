@@ -0,0 +1,90 @@
+#ifndef DOTMATRIX_ANIM_H
+#define DOTMATRIX_ANIM_H
+
+/**
+ * Delta-compressed animations for the dot matrix, played from flash.
+ *
+ * Frames are stored in the screen layout (digit-major), each one XORed
+ * with the previous frame and run-length coded. A keyframe is coded
+ * against a blank screen, so playback can restart there.
+ *
+ * Frame: flags byte (DMTX_ANIM_KEY), then tokens covering frame_len bytes:
+ *   0x80 | (n-1)        - n bytes unchanged (XOR 0), n = 1..128
+ *   (n-1), n data bytes - n bytes XORed into the screen, n = 1..128
+ *
+ * Use tools/anim2c.php to convert PNG sequences.
+ *
+ * Nothing here allocates memory; the player struct is
+ * provided by the caller (typically static).
+ */
+
+#include "main.h"
+#include "dotmatrix.h"
+#include "utils/timebase.h"
+
+/** Frame flag: coded against a blank screen */
+#define DMTX_ANIM_KEY 0x01
+
+/** Token flag: run of unchanged bytes */
+#define DMTX_ANIM_SKIP 0x80
+
+typedef struct {
+	uint32_t frame_len; /*!< Bytes per frame, must be modules * 8 of the target matrix */
+	uint16_t frames; /*!< Number of frames */
+	uint16_t frame_ms; /*!< Frame duration */
+	const uint8_t *data; /*!< Coded frames, back to back */
+} DotMatrix_Anim;
+
+typedef struct {
+	DotMatrix_Cfg *dmtx;
+	const DotMatrix_Anim *anim; /*!< Animation being played */
+	const uint8_t *next; /*!< Next coded frame */
+	uint16_t frame; /*!< Index of the next frame */
+	bool loop; /*!< Start over after the last frame */
+	uint32_t decode_cycles; /*!< CPU cycles of the last frame decode */
+	uint32_t decode_cycles_max; /*!< Longest frame decode */
+	task_pid_t task; /*!< Periodic task, PID_NONE if stopped */
+} DotMatrix_AnimPlayer;
+
+
+/**
+ * @brief Start playing an animation; each frame is shown when decoded
+ * @param pl : player struct (caller owned, zero-initialized)
+ * @param dmtx : driver struct, frame_len must match its screen size
+ * @param anim : animation (in flash)
+ * @param loop : repeat forever; otherwise stop on the last frame
+ */
+void dmtx_anim_start(DotMatrix_AnimPlayer *pl, DotMatrix_Cfg* dmtx, const DotMatrix_Anim *anim, bool loop);
+
+/** Stop playing (the last frame stays on the screen) */
+void dmtx_anim_stop(DotMatrix_AnimPlayer *pl);
+
+/** Check if the player's task is running */
+bool dmtx_anim_playing(DotMatrix_AnimPlayer *pl);
+
+/** Print the playback position and decode cost to debug output */
+void dmtx_anim_report(DotMatrix_AnimPlayer *pl);
+
+/**
+ * @brief Decode the next frame into the screen buffer, without showing
+ *
+ * Deltas apply to the previous frame: with a double-buffered matrix,
+ * the front buffer is copied to the screen buffer first.
+ *
+ * @param pl : player struct
+ * @return false after the last frame (if not looping)
+ */
+bool dmtx_anim_step(DotMatrix_AnimPlayer *pl);
+
+/**
+ * @brief Decode a coded frame into a screen-layout buffer
+ * @param frame : coded frame
+ * @param buf : buffer holding the previous frame (cleared first for a keyframe)
+ * @param len : frame length in bytes
+ * @param digits : mask of changed digits is stored here, bit 0 = DIGIT0
+ * @param row_len : digit row length of buf (modules)
+ * @return pointer past the coded frame
+ */
+const uint8_t* dmtx_anim_decode(const uint8_t *frame, uint8_t *buf, uint32_t len, uint8_t *digits, uint32_t row_len);
+
+#endif // DOTMATRIX_ANIM_H
@@ -0,0 +1,221 @@
+#include "dotmatrix_gray.h"
+#include "malloc_safe.h"
+#include "com/debug.h"
+#include "utils/cycles.h"
+
+// the timer interrupt needs the instance
+static DotMatrix_Gray *gray_inst = NULL;
+
+
+DotMatrix_Gray* dmtx_gray_init(DotMatrix_Cfg *dmtx, uint8_t bits, uint16_t lsb_us)
+{
+	DotMatrix_Gray *gray = calloc_s(1, sizeof(DotMatrix_Gray));
+
+	const uint32_t plane_len = dmtx->modules * 8;
+
+	if (bits < 2) bits = 2;
+	if (bits > 4) bits = 4;
+
+	gray->dmtx = dmtx;
+	gray->bits = bits;
+	gray->lsb_us = lsb_us;
+	gray->planes = calloc_s(plane_len * bits, 1);
+	gray->streams[0] = calloc_s(plane_len * bits, sizeof(uint16_t));
+	gray->streams[1] = calloc_s(plane_len * bits, sizeof(uint16_t));
+
+	// SPI load estimate - the chains are sent in parallel, the longest one counts
+	RCC_ClocksTypeDef clocks;
+	RCC_GetClocksFreq(&clocks);
+
+	gray->stats.spi_bytes = plane_len * bits * 2;
+	gray->stats.spi_us = 0;
+
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		const MAX2719_Cfg *drv = &dmtx->drv[c];
+
+		uint32_t pclk = (drv->SPIx == SPI1) ? clocks.PCLK2_Frequency : clocks.PCLK1_Frequency;
+		uint32_t baud = pclk >> (((drv->SPIx->CR1 & SPI_CR1_BR) >> 3) + 1);
+		uint32_t bytes = drv->chain_len * 8 * bits * 2;
+		uint32_t us = (uint32_t)((uint64_t)bytes * 8 * 1000000 / baud);
+
+		if (us > gray->stats.spi_us) gray->stats.spi_us = us;
+	}
+	gray->stats.frame_us = (uint32_t)lsb_us * ((1 << bits) - 1);
+
+	// 1 MHz timer tick
+	RCC_APB1PeriphClockCmd(RCC_APB1ENR_TIM4EN, ENABLE);
+	TIM_DeInit(TIM4);
+	TIM_TimeBaseInitTypeDef tim_cnf;
+	tim_cnf.TIM_Period = lsb_us - 1;
+	tim_cnf.TIM_Prescaler = (F_CPU / 1000000) - 1;
+	tim_cnf.TIM_ClockDivision = TIM_CKD_DIV1;
+	tim_cnf.TIM_CounterMode = TIM_CounterMode_Up;
+	tim_cnf.TIM_RepetitionCounter = 0x0000;
+	TIM_TimeBaseInit(TIM4, &tim_cnf);
+	TIM_ClearITPendingBit(TIM4, TIM_IT_Update);
+	TIM_ITConfig(TIM4, TIM_IT_Update, ENABLE);
+
+	gray_inst = gray;
+	NVIC_EnableIRQ(TIM4_IRQn);
+
+	return gray;
+}
+
+
+void dmtx_gray_start(DotMatrix_Gray *gray)
+{
+	dmtx_wait(gray->dmtx);
+
+	gray->plane = gray->bits - 1; // first interrupt wraps to plane 0
+	TIM_SetCounter(TIM4, 0);
+	TIM_Cmd(TIM4, ENABLE);
+}
+
+
+void dmtx_gray_stop(DotMatrix_Gray *gray)
+{
+	TIM_Cmd(TIM4, DISABLE);
+	dmtx_wait(gray->dmtx);
+
+	dmtx_invalidate(gray->dmtx);
+}
+
+
+void dmtx_gray_clear(DotMatrix_Gray *gray)
+{
+	memset(gray->planes, 0, gray->dmtx->modules * 8 * gray->bits);
+}
+
+
+/** Byte index of a pixel in a plane; -1 if outside */
+static int32_t cell_index(DotMatrix_Cfg *dmtx, int32_t x, int32_t y)
+{
+	if (x < 0 || y < 0) return -1;
+	if ((uint32_t)x >= dmtx->cols*8 || (uint32_t)y >= dmtx->rows*8) return -1;
+
+	return (y & 7) * dmtx->modules + (y >> 3) * dmtx->cols + (x >> 3);
+}
+
+
+void dmtx_gray_set(DotMatrix_Gray *gray, int32_t x, int32_t y, uint8_t level)
+{
+	int32_t idx = cell_index(gray->dmtx, x, y);
+	if (idx < 0) return;
+
+	const uint32_t plane_len = gray->dmtx->modules * 8;
+	const uint8_t mask = 1 << (x & 7);
+	uint8_t *cell = gray->planes + idx;
+
+	for (uint8_t p = 0; p < gray->bits; p++) {
+		if (level & (1 << p)) {
+			*cell |= mask;
+		} else {
+			*cell &= ~mask;
+		}
+		cell += plane_len;
+	}
+}
+
+
+uint8_t dmtx_gray_get(DotMatrix_Gray *gray, int32_t x, int32_t y)
+{
+	int32_t idx = cell_index(gray->dmtx, x, y);
+	if (idx < 0) return 0;
+
+	const uint32_t plane_len = gray->dmtx->modules * 8;
+	const uint8_t mask = 1 << (x & 7);
+	const uint8_t *cell = gray->planes + idx;
+	uint8_t level = 0;
+
+	for (uint8_t p = 0; p < gray->bits; p++) {
+		if (*cell & mask) level |= 1 << p;
+		cell += plane_len;
+	}
+
+	return level;
+}
+
+
+void dmtx_gray_commit(DotMatrix_Gray *gray)
+{
+	uint32_t start = cyc_now();
+
+	DotMatrix_Cfg *dmtx = gray->dmtx;
+	const uint32_t plane_len = dmtx->modules * 8;
+
+	// keep the interrupt off the set being built
+	gray->pending = false;
+	uint16_t *set = gray->streams[gray->shown ^ 1];
+
+	// each chain's rows follow the previous chain's within a plane
+	for (uint8_t p = 0; p < gray->bits; p++) {
+		const uint8_t *data = dmtx_physical(dmtx, gray->planes + p * plane_len);
+
+		for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+			const uint32_t first = dmtx->chain_first[c];
+			max2719_build_stream(&dmtx->drv[c], data + first, 0xFF, set + p * plane_len + first * 8);
+		}
+	}
+
+	gray->pending = true;
+
+	gray->stats.commit_cycles = cyc_elapsed(start);
+}
+
+
+void dmtx_gray_report(DotMatrix_Gray *gray)
+{
+	DotMatrix_GrayStats *st = &gray->stats;
+
+	dbg("Gray: %d bits, %"PRIu32" modules, frame %"PRIu32" us", gray->bits, gray->dmtx->modules, st->frame_us);
+	dbg("  frames %"PRIu32", late planes %"PRIu32, st->frames, st->late);
+	dbg("  SPI %"PRIu32" B / %"PRIu32" us per frame (%"PRIu32" %% busy)",
+		st->spi_bytes, st->spi_us, st->spi_us * 100 / st->frame_us);
+	dbg("  CPU %"PRIu32" cyc/frame in IRQ, commit %"PRIu32" cyc",
+		st->isr_cycles, st->commit_cycles);
+}
+
+
+/** Next plane - binary weighted duration */
+void TIM4_IRQHandler(void)
+{
+	TIM_ClearITPendingBit(TIM4, TIM_IT_Update);
+
+	DotMatrix_Gray *gray = gray_inst;
+	if (gray == NULL) return;
+
+	uint32_t start = cyc_now();
+
+	uint8_t plane = gray->plane + 1;
+	if (plane >= gray->bits) {
+		plane = 0;
+
+		gray->stats.frames++;
+		gray->stats.isr_cycles = gray->frame_cycles;
+		gray->frame_cycles = 0;
+
+		// new content is taken only at a frame boundary
+		if (gray->pending) {
+			gray->shown ^= 1;
+			gray->pending = false;
+		}
+	}
+	gray->plane = plane;
+
+	TIM4->ARR = ((uint32_t)gray->lsb_us << plane) - 1;
+
+	DotMatrix_Cfg *dmtx = gray->dmtx;
+	const uint32_t plane_len = dmtx->modules * 8;
+	const uint16_t *stream = gray->streams[gray->shown] + plane * plane_len;
+	bool late = false;
+
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		if (!max2719_send_stream(&dmtx->drv[c], stream + dmtx->chain_first[c] * 8, 8)) {
+			late = true;
+		}
+	}
+
+	if (late) gray->stats.late++;
+
+	gray->frame_cycles += cyc_elapsed(start);
+}
@@ -0,0 +1,72 @@
+#ifndef DOTMATRIX_GRAY_H
+#define DOTMATRIX_GRAY_H
+
+/**
+ * Grayscale mode for the dot matrix, using bit-angle modulation.
+ *
+ * Pixels have 2-4 bits, stored as bit-planes in the screen layout.
+ * TIM4 shows plane k for (lsb_us << k) microseconds. Each plane is
+ * pushed with DMA from a stream prebuilt by dmtx_gray_commit(), so the
+ * refresh costs one short interrupt per plane regardless of content.
+ *
+ * Don't call dmtx_show() or other dmtx_ sending functions while running.
+ */
+
+#include "main.h"
+#include "dotmatrix.h"
+
+typedef struct {
+	uint32_t frames; /*!< BAM frames shown (all planes) */
+	uint32_t late; /*!< Plane pushes skipped because the previous one was still running */
+	uint32_t isr_cycles; /*!< CPU cycles spent in the plane interrupts during the last frame */
+	uint32_t commit_cycles; /*!< CPU cycles of the last dmtx_gray_commit() */
+	uint32_t spi_bytes; /*!< SPI bytes per BAM frame */
+	uint32_t spi_us; /*!< SPI time per BAM frame */
+	uint32_t frame_us; /*!< BAM frame period */
+} DotMatrix_GrayStats;
+
+typedef struct {
+	DotMatrix_Cfg *dmtx;
+	uint8_t bits; /*!< Bits per pixel */
+	uint16_t lsb_us; /*!< Duration of the least significant plane */
+	uint8_t *planes; /*!< Bit-planes, each in the screen layout; plane 0 is the LSB */
+	uint16_t *streams[2]; /*!< Prebuilt plane streams - shown and pending */
+	volatile uint8_t shown; /*!< Index of the shown stream set */
+	volatile bool pending; /*!< The other stream set is ready to be shown */
+	volatile uint8_t plane; /*!< Plane being shown */
+	uint32_t frame_cycles; /*!< Interrupt cycles accumulated in this frame */
+	DotMatrix_GrayStats stats;
+} DotMatrix_Gray;
+
+
+/**
+ * @brief Set up the grayscale mode (does not start it)
+ * @param dmtx : dot matrix, must use a DMA-capable SPI
+ * @param bits : bits per pixel, 2-4
+ * @param lsb_us : LSB plane duration; one plane push must fit in it
+ * @return the instance
+ */
+DotMatrix_Gray* dmtx_gray_init(DotMatrix_Cfg *dmtx, uint8_t bits, uint16_t lsb_us);
+
+/** Start the refresh timer */
+void dmtx_gray_start(DotMatrix_Gray *gray);
+
+/** Stop the refresh; the next dmtx_show() re-sends the whole screen */
+void dmtx_gray_stop(DotMatrix_Gray *gray);
+
+/** Clear all planes (not showing) */
+void dmtx_gray_clear(DotMatrix_Gray *gray);
+
+/** Set pixel level, 0 .. (1<<bits)-1 */
+void dmtx_gray_set(DotMatrix_Gray *gray, int32_t x, int32_t y, uint8_t level);
+
+/** Get pixel level */
+uint8_t dmtx_gray_get(DotMatrix_Gray *gray, int32_t x, int32_t y);
+
+/** Build the plane streams; shown from the next BAM frame on */
+void dmtx_gray_commit(DotMatrix_Gray *gray);
+
+/** Print the stats to the debug interface */
+void dmtx_gray_report(DotMatrix_Gray *gray);
+
+#endif // DOTMATRIX_GRAY_H
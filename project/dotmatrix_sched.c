@@ -0,0 +1,88 @@
+#include "dotmatrix_sched.h"
+#include "com/debug.h"
+
+
+/** Show the waiting frame, if any */
+static void sched_tick(void *arg)
+{
+	DotMatrix_Sched *sched = arg;
+
+	if (!sched->ready) {
+		sched->stats.idle++;
+
+		// nothing changed, but keep re-asserting the config registers
+		if (++sched->idle_run >= DMTX_SCHED_SCRUB_TICKS && !dmtx_busy(sched->dmtx)) {
+			dmtx_show(sched->dmtx);
+			sched->idle_run = 0;
+			sched->stats.scrubs++;
+		}
+		return;
+	}
+
+	// try again on the next tick
+	if (dmtx_busy(sched->dmtx)) {
+		sched->stats.late++;
+		return;
+	}
+
+	dmtx_show(sched->dmtx);
+	sched->ready = false;
+	sched->idle_run = 0;
+	sched->stats.shown++;
+}
+
+
+void dmtx_sched_start(DotMatrix_Sched *sched, DotMatrix_Cfg *dmtx, uint32_t rate_hz)
+{
+	dmtx_sched_stop(sched);
+
+	if (rate_hz == 0) rate_hz = 1;
+
+	sched->dmtx = dmtx;
+	sched->rate_hz = rate_hz;
+	sched->interval = (1000 + rate_hz / 2) / rate_hz;
+	if (sched->interval == 0) sched->interval = 1;
+	sched->ready = false;
+	sched->idle_run = 0;
+
+	sched->task = add_periodic_task(sched_tick, sched, sched->interval, true);
+}
+
+
+void dmtx_sched_stop(DotMatrix_Sched *sched)
+{
+	if (sched->task != PID_NONE) {
+		remove_periodic_task(sched->task);
+		sched->task = PID_NONE;
+	}
+}
+
+
+void dmtx_sched_submit(DotMatrix_Sched *sched)
+{
+	sched->stats.produced++;
+
+	if (sched->ready) {
+		sched->stats.dropped++;
+	}
+
+	dmtx_swap(sched->dmtx);
+	sched->ready = true;
+}
+
+
+void dmtx_sched_reset_stats(DotMatrix_Sched *sched)
+{
+	memset(&sched->stats, 0, sizeof(DotMatrix_SchedStats));
+}
+
+
+void dmtx_sched_report(DotMatrix_Sched *sched)
+{
+	DotMatrix_SchedStats *st = &sched->stats;
+
+	dbg("Frames: %"PRIu32" Hz (%"PRIu32" ms)", sched->rate_hz, (uint32_t)sched->interval);
+	dbg("  produced %"PRIu32", shown %"PRIu32", dropped %"PRIu32,
+		st->produced, st->shown, st->dropped);
+	dbg("  late ticks %"PRIu32", idle ticks %"PRIu32" (%"PRIu32" scrub shows)", st->late, st->idle, st->scrubs);
+}
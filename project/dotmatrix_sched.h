@@ -0,0 +1,75 @@
+#ifndef DOTMATRIX_SCHED_H
+#define DOTMATRIX_SCHED_H
+
+/**
+ * Fixed-rate frame scheduler for the dot matrix.
+ *
+ * The renderer draws into the screen buffer and hands each completed
+ * frame over with dmtx_sched_submit(); a periodic task shows the latest
+ * one at a fixed rate, so the refresh doesn't jitter with the rendering
+ * load. A frame replaced by a newer one before its tick is dropped.
+ *
+ * While no new frames come, the unchanged frame is re-shown every
+ * DMTX_SCHED_SCRUB_TICKS ticks - an empty update, but it carries the
+ * config register scrub (see max2719_build_sparse()), so a static
+ * picture still recovers from a driver upset.
+ *
+ * Needs a double-buffered matrix. Nothing here allocates memory;
+ * the scheduler struct is provided by the caller (typically static).
+ */
+
+#include "main.h"
+#include "dotmatrix.h"
+#include "utils/timebase.h"
+
+/** Idle ticks between scrub-only shows */
+#define DMTX_SCHED_SCRUB_TICKS 6
+
+typedef struct {
+	uint32_t produced; /*!< Frames submitted by the renderer */
+	uint32_t shown; /*!< Frames pushed to the display */
+	uint32_t dropped; /*!< Frames replaced by a newer one before being shown */
+	uint32_t late; /*!< Ticks postponed because the previous push was still running */
+	uint32_t idle; /*!< Ticks with no new frame to show */
+	uint32_t scrubs; /*!< Idle ticks that re-showed the frame for scrubbing */
+} DotMatrix_SchedStats;
+
+typedef struct {
+	DotMatrix_Cfg *dmtx;
+	uint32_t rate_hz; /*!< Requested frame rate */
+	ms_time_t interval; /*!< Tick interval (the timebase has 1 ms resolution) */
+	bool ready; /*!< A submitted frame is waiting in the front buffer */
+	uint32_t idle_run; /*!< Idle ticks since the last show */
+	task_pid_t task; /*!< Periodic task, PID_NONE if stopped */
+	DotMatrix_SchedStats stats;
+} DotMatrix_Sched;
+
+
+/**
+ * @brief Start showing submitted frames at a fixed rate
+ * @param sched : scheduler struct (caller owned, zero-initialized)
+ * @param dmtx : driver struct (double-buffered)
+ * @param rate_hz : frames per second, eg. 60 or 100 (rounded to whole ms)
+ */
+void dmtx_sched_start(DotMatrix_Sched *sched, DotMatrix_Cfg *dmtx, uint32_t rate_hz);
+
+/** Stop the scheduler; a waiting frame is not shown */
+void dmtx_sched_stop(DotMatrix_Sched *sched);
+
+/**
+ * @brief Hand over the frame drawn in the screen buffer
+ *
+ * The buffers are swapped; a previous frame not shown yet is dropped.
+ * The screen buffer then holds an older frame - redraw it fully.
+ *
+ * @param sched : scheduler struct
+ */
+void dmtx_sched_submit(DotMatrix_Sched *sched);
+
+/** Clear the statistics */
+void dmtx_sched_reset_stats(DotMatrix_Sched *sched);
+
+/** Print the statistics to debug output */
+void dmtx_sched_report(DotMatrix_Sched *sched);
+
+#endif // DOTMATRIX_SCHED_H
@@ -0,0 +1,103 @@
+#include "dotmatrix_text.h"
+#include "font.h"
+
+
+/** Column 'col' of the text stream (glyph columns with spacing) */
+static uint8_t text_column(const char *str, uint32_t col)
+{
+	uint32_t gcol = col % DMTX_CHAR_STEP;
+	if (gcol >= FONT_WIDTH) return 0; // spacing
+
+	return font_glyph(str[col / DMTX_CHAR_STEP])[gcol];
+}
+
+
+int32_t dmtx_text(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, const char *str)
+{
+	for (; *str; str++) {
+		const uint8_t *glyph = font_glyph(*str);
+
+		for (uint32_t i = 0; i < FONT_WIDTH; i++) {
+			dmtx_set_column(dmtx, x++, y, glyph[i]);
+		}
+		dmtx_set_column(dmtx, x++, y, 0);
+	}
+
+	return x;
+}
+
+
+int32_t dmtx_canvas_text(DotMatrix_Canvas *cv, int32_t x, uint32_t band, const char *str)
+{
+	if (band >= cv->bands) return x;
+
+	uint8_t *row = cv->columns + band * cv->width;
+
+	// glyphs are packed columns already
+	for (; *str; str++) {
+		const uint8_t *glyph = font_glyph(*str);
+
+		for (uint32_t i = 0; i < DMTX_CHAR_STEP; i++, x++) {
+			int32_t cx = x % (int32_t)cv->width;
+			if (cx < 0) cx += cv->width;
+
+			row[cx] = (i < FONT_WIDTH) ? glyph[i] : 0;
+		}
+	}
+
+	return x;
+}
+
+
+void dmtx_scroll_step(DotMatrix_Scroller *scr)
+{
+	const uint32_t text_cols = scr->len * DMTX_CHAR_STEP;
+
+	uint8_t bits = 0;
+	if (scr->pos < text_cols) {
+		bits = text_column(scr->text, scr->pos);
+	}
+
+	// the gap lets the text leave the window before it starts again
+	if (++scr->pos >= text_cols + scr->w) {
+		scr->pos = 0;
+	}
+
+	dmtx_shift_left(scr->dmtx, scr->x, scr->y, scr->w, 8);
+	dmtx_set_column(scr->dmtx, scr->x + scr->w - 1, scr->y, bits);
+}
+
+
+static void scroll_task(void *arg)
+{
+	DotMatrix_Scroller *scr = arg;
+
+	dmtx_scroll_step(scr);
+	dmtx_show(scr->dmtx);
+}
+
+
+void dmtx_scroll_start(DotMatrix_Scroller *scr, DotMatrix_Cfg* dmtx, const char *text,
+					   int32_t x, int32_t y, int32_t w, ms_time_t interval)
+{
+	dmtx_scroll_stop(scr);
+
+	scr->dmtx = dmtx;
+	scr->text = text;
+	scr->len = strlen(text);
+	scr->x = x;
+	scr->y = y;
+	scr->w = w;
+	scr->pos = 0;
+
+	scr->task = add_periodic_task(scroll_task, scr, interval, true);
+}
+
+
+void dmtx_scroll_stop(DotMatrix_Scroller *scr)
+{
+	if (scr->task != PID_NONE) {
+		remove_periodic_task(scr->task);
+		scr->task = PID_NONE;
+	}
+}
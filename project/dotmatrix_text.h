@@ -0,0 +1,74 @@
+#ifndef DOTMATRIX_TEXT_H
+#define DOTMATRIX_TEXT_H
+
+/**
+ * Text output and marquee scrolling for the dot matrix,
+ * using the 5x7 flash font.
+ *
+ * Nothing here allocates memory; the scroller struct is
+ * provided by the caller (typically static).
+ */
+
+#include "main.h"
+#include "dotmatrix.h"
+#include "utils/timebase.h"
+
+/** Glyph advance - font width + 1 column of spacing */
+#define DMTX_CHAR_STEP 6
+
+typedef struct {
+	DotMatrix_Cfg *dmtx;
+	const char *text; /*!< Scrolled text, must stay valid while scrolling */
+	uint32_t len; /*!< Text length */
+	int32_t x; /*!< Window left edge */
+	int32_t y; /*!< Window top edge */
+	int32_t w; /*!< Window width */
+	uint32_t pos; /*!< Index of the next column (glyph columns, then a blank gap of w) */
+	task_pid_t task; /*!< Periodic task, PID_NONE if stopped */
+} DotMatrix_Scroller;
+
+
+/**
+ * @brief Draw a string, each character in a 6x8 cell (overwritten)
+ * @param dmtx : driver struct
+ * @param x : left edge
+ * @param y : top edge
+ * @param str : string to draw
+ * @return x after the last character
+ */
+int32_t dmtx_text(DotMatrix_Cfg* dmtx, int32_t x, int32_t y, const char *str);
+
+/**
+ * @brief Draw a string into a canvas band, each character in a 6x8 cell (overwritten)
+ * @param cv : canvas
+ * @param x : left edge, wraps around the canvas width
+ * @param band : 8-row band (y / 8)
+ * @param str : string to draw
+ * @return x after the last character (not wrapped)
+ */
+int32_t dmtx_canvas_text(DotMatrix_Canvas *cv, int32_t x, uint32_t band, const char *str);
+
+/**
+ * @brief Start scrolling text through a window, right to left.
+ *
+ * Each step shifts the window by one column and draws only the new
+ * column, then shows the screen. Use with a single-buffered matrix.
+ *
+ * @param scr : scroller struct (caller owned, zero-initialized)
+ * @param dmtx : driver struct
+ * @param text : text to scroll (not copied), repeated after a blank gap
+ * @param x : window left edge
+ * @param y : window top edge (8 rows tall)
+ * @param w : window width
+ * @param interval : ms per step
+ */
+void dmtx_scroll_start(DotMatrix_Scroller *scr, DotMatrix_Cfg* dmtx, const char *text,
+					   int32_t x, int32_t y, int32_t w, ms_time_t interval);
+
+/** Stop scrolling (the window content is kept) */
+void dmtx_scroll_stop(DotMatrix_Scroller *scr);
+
+/** Advance by one column, without showing */
+void dmtx_scroll_step(DotMatrix_Scroller *scr);
+
+#endif // DOTMATRIX_TEXT_H
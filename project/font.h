@@ -0,0 +1,27 @@
+#ifndef FONT_H
+#define FONT_H
+
+/**
+ * 5x7 font, ASCII 0x20..0x7E.
+ *
+ * Glyphs are stored in flash column by column, one byte per column,
+ * bit 0 being the top row.
+ */
+
+#include "main.h"
+
+#define FONT_WIDTH 5
+#define FONT_HEIGHT 7
+#define FONT_FIRST ' '
+#define FONT_LAST '~'
+
+extern const uint8_t font5x7[FONT_LAST - FONT_FIRST + 1][FONT_WIDTH];
+
+/** Get glyph columns for a character ('?' if not in the font) */
+static inline const uint8_t* font_glyph(char c)
+{
+	if (c < FONT_FIRST || c > FONT_LAST) c = '?';
+	return font5x7[c - FONT_FIRST];
+}
+
+#endif // FONT_H
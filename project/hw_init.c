@@ -6,6 +6,7 @@
 
 #include "utils/debounce.h"
 #include "utils/timebase.h"
+#include "utils/cycles.h"
 
 #include "bus/event_queue.h"
 #include "com/debug.h"
@@ -48,6 +49,9 @@ static void conf_irq_prios(void)
 	NVIC_SetPriority(SysTick_IRQn, 0); // SysTick - for timeouts
 	NVIC_SetPriority(USART2_IRQn, 6); // USART - datalink
 	NVIC_SetPriority(USART1_IRQn, 10); // USART - debug
+	NVIC_SetPriority(DMA1_Channel3_IRQn, 8); // SPI1 Tx DMA - dot matrix
+	NVIC_SetPriority(DMA1_Channel5_IRQn, 8); // SPI2 Tx DMA - dot matrix, 2nd chain
+	NVIC_SetPriority(TIM4_IRQn, 9); // grayscale refresh - must be below the DMA
 
 	// FIXME check , probably bad ports
 }
@@ -58,6 +62,9 @@ static void conf_irq_prios(void)
  */
 static void conf_subsystems(void)
 {
+	// profiling
+	cyc_init();
+
 	// task scheduler subsystem
 	timebase_init(15, 15);
 
@@ -114,6 +121,17 @@ static void conf_gpio(void)
 	gpio_cnf.GPIO_Mode = GPIO_Mode_Out_PP;
 	gpio_cnf.GPIO_Speed = GPIO_Speed_10MHz;
 	GPIO_Init(GPIOA, &gpio_cnf);
+
+	// SPI2 - 2nd display chain
+	gpio_cnf.GPIO_Pin = GPIO_Pin_13 | GPIO_Pin_15;
+	gpio_cnf.GPIO_Mode = GPIO_Mode_AF_PP;
+	gpio_cnf.GPIO_Speed = GPIO_Speed_10MHz;
+	GPIO_Init(GPIOB, &gpio_cnf);
+	// SPI2 NSS out
+	gpio_cnf.GPIO_Pin = GPIO_Pin_12;
+	gpio_cnf.GPIO_Mode = GPIO_Mode_Out_PP;
+	gpio_cnf.GPIO_Speed = GPIO_Speed_10MHz;
+	GPIO_Init(GPIOB, &gpio_cnf);
 }
 
 
@@ -139,18 +157,26 @@ static void conf_usart(void)
 static void conf_spi(void)
 {
 	RCC_APB2PeriphClockCmd(RCC_APB2ENR_SPI1EN, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1ENR_SPI2EN, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBENR_DMA1EN, ENABLE); // Tx DMA
 
 	SPI_InitTypeDef spi_cnf;
 	SPI_StructInit(&spi_cnf);
 
 	spi_cnf.SPI_Direction = SPI_Direction_1Line_Tx;
 	spi_cnf.SPI_Mode = SPI_Mode_Master;
+	spi_cnf.SPI_DataSize = SPI_DataSize_16b; // one MAX2719 word per frame
 	spi_cnf.SPI_NSS = SPI_NSS_Soft;
 	spi_cnf.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_8;
 
 	SPI_Init(SPI1, &spi_cnf);
 
+	// SPI2 is on the half-speed APB1 - same 9 MHz
+	spi_cnf.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_4;
+	SPI_Init(SPI2, &spi_cnf);
+
 	SPI_Cmd(SPI1, ENABLE);
+	SPI_Cmd(SPI2, ENABLE);
 }
 
 
@@ -196,39 +222,70 @@ static void conf_adc(void)
 
 	// Configure the DMA timer
 	TIM_DeInit(TIM3);
+	adc_set_sample_rate(ADC_SAMPLE_RATE_DEFAULT);
+
+	TIM_SelectOutputTrigger(TIM3, TIM_TRGOSource_Update);
+
+	//TIM3->CR1 |= TIM_CR1_URS; // generate update on overflow
+	//TIM3->CR2 |= TIM_CR2_MMS_1; // trig on update
+}
+
+
+// ---- Continuous capture ----
+// The DMA runs in circular mode over two blocks; the half-transfer
+// and transfer-complete interrupts hand the finished block over
+// while the other one is being filled.
+
+static uint16_t *adc_ring; // both blocks
+static uint32_t adc_block_len; // samples per block
+static volatile bool adc_block_busy; // a block is being processed
+static volatile uint32_t adc_overruns; // blocks skipped because processing fell behind
+
+
+uint32_t adc_set_sample_rate(uint32_t rate)
+{
+	if (rate < ADC_SAMPLE_RATE_MIN || rate > ADC_SAMPLE_RATE_MAX) return 0;
+
+	// TIM3 runs at F_CPU (APB1 is F_CPU/2, timer clock doubled)
+	const uint32_t ticks = (F_CPU + rate / 2) / rate;
+	const uint32_t prescaler = (ticks - 1) / 65536 + 1;
+	const uint32_t period = (ticks + prescaler / 2) / prescaler;
+
 	TIM_TimeBaseInitTypeDef tim_cnf;
-	tim_cnf.TIM_Period = 1800;
-	tim_cnf.TIM_Prescaler = 1;
+	tim_cnf.TIM_Period = (uint16_t)(period - 1);
+	tim_cnf.TIM_Prescaler = (uint16_t)(prescaler - 1);
 	tim_cnf.TIM_ClockDivision = TIM_CKD_DIV1;
 	tim_cnf.TIM_CounterMode = TIM_CounterMode_Up;
 	tim_cnf.TIM_RepetitionCounter = 0x0000;
 	TIM_TimeBaseInit(TIM3, &tim_cnf);
 
-	TIM_SelectOutputTrigger(TIM3, TIM_TRGOSource_Update);
-
-	//TIM3->CR1 |= TIM_CR1_URS; // generate update on overflow
-	//TIM3->CR2 |= TIM_CR2_MMS_1; // trig on update
+	return F_CPU / (prescaler * period);
 }
 
 
-void start_adc_dma(uint32_t *memory, uint32_t count)
+void start_adc_dma(uint16_t *memory, uint32_t count)
 {
+	adc_ring = memory;
+	adc_block_len = count / 2;
+	adc_block_busy = false;
+
+	TIM_Cmd(TIM3, DISABLE);
 	ADC_Cmd(ADC1, DISABLE);
 	DMA_DeInit(DMA1_Channel1);
 	DMA_InitTypeDef dma_cnf;
 	dma_cnf.DMA_PeripheralBaseAddr = (uint32_t)&ADC1->DR;
 	dma_cnf.DMA_MemoryBaseAddr = (uint32_t)memory;
 	dma_cnf.DMA_DIR = DMA_DIR_PeripheralSRC;
-	dma_cnf.DMA_BufferSize = count;
+	dma_cnf.DMA_BufferSize = adc_block_len * 2;
 	dma_cnf.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
 	dma_cnf.DMA_MemoryInc = DMA_MemoryInc_Enable;
-	dma_cnf.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
-	dma_cnf.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
-	dma_cnf.DMA_Mode = DMA_Mode_Normal;
+	dma_cnf.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord; // 12-bit result
+	dma_cnf.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	dma_cnf.DMA_Mode = DMA_Mode_Circular;
 	dma_cnf.DMA_Priority = DMA_Priority_Low;
 	dma_cnf.DMA_M2M = DMA_M2M_Disable;
 	DMA_Init(DMA1_Channel1, &dma_cnf);
-	DMA_ITConfig(DMA1_Channel1, DMA1_IT_TC1, ENABLE);
+	DMA_ITConfig(DMA1_Channel1, DMA1_IT_HT1 | DMA1_IT_TC1, ENABLE);
 
 	ADC_Cmd(ADC1, ENABLE);
 	ADC_DMACmd(ADC1, ENABLE);
@@ -237,14 +294,47 @@ void start_adc_dma(uint32_t *memory, uint32_t count)
 }
 
 
-void DMA1_Channel1_IRQHandler(void)
+void stop_adc_dma(void)
 {
-	DMA_ClearITPendingBit(DMA1_IT_TC1);
-	DMA_ClearITPendingBit(DMA1_IT_TE1);
-
-	DMA_DeInit(DMA1_Channel1);
 	TIM_Cmd(TIM3, DISABLE);
 	ADC_DMACmd(ADC1, DISABLE);
+	DMA_DeInit(DMA1_Channel1);
+}
+
 
-	tq_post(audio_capture_done, NULL);
+void adc_block_done(void)
+{
+	adc_block_busy = false;
+}
+
+
+uint32_t adc_overrun_count(void)
+{
+	return adc_overruns;
+}
+
+
+void DMA1_Channel1_IRQHandler(void)
+{
+	uint16_t *block;
+
+	if (DMA_GetITStatus(DMA1_IT_TC1)) {
+		block = adc_ring + adc_block_len; // second half done
+	} else {
+		block = adc_ring; // first half done
+	}
+
+	DMA_ClearITPendingBit(DMA1_IT_GL1);
+
+	// the previous block is still being processed
+	if (adc_block_busy) {
+		adc_overruns++;
+		return;
+	}
+
+	adc_block_busy = true;
+	if (!tq_post(audio_capture_done, block)) {
+		adc_block_busy = false;
+		adc_overruns++;
+	}
 }
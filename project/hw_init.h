@@ -4,4 +4,40 @@
 
 void hw_init(void);
 
-void start_adc_dma(uint32_t *memory, uint32_t count);
+/** Sample rate set up by hw_init() */
+#define ADC_SAMPLE_RATE_DEFAULT 20000
+
+/** Sample rate limits, Hz (the ADC converts in about 1.2 us) */
+#define ADC_SAMPLE_RATE_MIN 100
+#define ADC_SAMPLE_RATE_MAX 200000
+
+/**
+ * @brief Set the ADC trigger rate (TIM3 update)
+ *
+ * Applied right away (the timer is reloaded); the capture may be running.
+ *
+ * @param rate : sample rate, Hz
+ * @return the rate achieved (the nearest the timer can do), 0 if out of range
+ */
+uint32_t adc_set_sample_rate(uint32_t rate);
+
+/**
+ * @brief Start continuous audio capture
+ *
+ * The buffer is filled in a loop, in two blocks of count/2 samples.
+ * Each finished block is passed to audio_capture_done(), which must
+ * call adc_block_done() when it no longer needs it.
+ *
+ * @param memory : sample buffer (both blocks), 12-bit right-aligned samples
+ * @param count : total number of samples, even
+ */
+void start_adc_dma(uint16_t *memory, uint32_t count);
+
+/** Stop the capture */
+void stop_adc_dma(void);
+
+/** Release the block passed to audio_capture_done() */
+void adc_block_done(void);
+
+/** Number of blocks dropped because the previous one wasn't released in time */
+uint32_t adc_overrun_count(void);
@@ -15,115 +15,437 @@
 
 //#include "matrixdsp.h"
 
+#include "com/datalink.h"
+#include "malloc_safe.h"
+
 #include "max2719.h"
 #include "dotmatrix.h"
+#include "dotmatrix_sched.h"
+#include "dotmatrix_anim.h"
+#include "anim_demo.h"
+#include "utils/cycles.h"
 
 #include "arm_math.h"
+#include "spectrum.h"
+#include "bands.h"
+#include "meter.h"
+#include "agc.h"
 
-static volatile bool capture_pending = false;
 static volatile bool print_next_fft = false;
 
-static float virt_zero_value = 2045.0f;
-
 static void poll_subsystems(void);
 
 static DotMatrix_Cfg *dmtx;
+static DotMatrix_Sched frame_sched;
+static DotMatrix_AnimPlayer anim_player; // replaces the spectrum while playing
+
+#define DISPLAY_FPS 60
+
+#define FFT_LEN_DEFAULT 128
+
+// display bands - one per column
+#define BAND_COUNT_MAX 64
+#define BAND_F_MIN 50
+#define BAND_F_MAX 10000
+
+// windows per fft_len samples: 1, 2 (50 % overlap) or 4 (75 %)
+#define OVERLAP_MAX 4
+static uint32_t overlap = 1;
+static uint32_t overlap_next; // waiting for the acquisition to be reconfigured, 0 = none
+
+// capture ring - two hops (fft_len / overlap), filled continuously by DMA
+static uint16_t *adc_buf;
+
+// last fft_len samples, when overlapping
+static uint16_t *history;
+static uint32_t history_head; // oldest sample
+static uint32_t history_fill; // hops captured since configured, up to overlap
+
+// processing time of a hop, for the load report
+static uint32_t proc_cycles;
+static uint32_t proc_cycles_max;
 
-#define SAMP_BUF_LEN 256
+static Spectrum *spectrum;
 
-union samp_buf_union {
-	uint32_t uints[SAMP_BUF_LEN];
-	float floats[SAMP_BUF_LEN];
-	uint8_t as_bytes[SAMP_BUF_LEN*sizeof(uint32_t)];
+static Bands *bands;
+static Bands_Scale band_scale = BANDS_LOG;
+static uint32_t sample_rate;
+
+static Meter *meter;
+
+static Agc agc;
+
+static const Agc_Params agc_defaults = {
+	.floor_db = -60,
+	.headroom_db = 3,
+	.range_db = 36,
+	.attack_ms = 20,
+	.release_ms = 3000,
 };
 
-// sample buffers (static - invalidated when sampling starts anew).
-static union samp_buf_union samp_buf;
+static const Meter_Params meter_defaults = {
+	.attack_ms = 10,
+	.release_ms = 150,
+	.hold_ms = 400,
+	.gravity = 60,
+};
 
-void audio_capture_done(void* unused)
-{
-	(void)unused;
+/** Datalink request answered with the next captured block */
+typedef struct {
+	uint8_t type; /*!< DG_REQUEST_RAW or DG_REQUEST_FFT, 0 = none */
+	uint16_t session; /*!< Session to respond in */
+	uint16_t count; /*!< Requested sample count */
+	uint32_t rate; /*!< Requested sample rate, Hz */
+	uint8_t skip; /*!< Blocks to let pass first (DC estimate settling) */
+} DlnkRequest;
 
-	const int samp_count = SAMP_BUF_LEN/2;
-	const int bin_count = SAMP_BUF_LEN/4;
+static DlnkRequest dlnk_req; // being answered
+static DlnkRequest dlnk_next; // waiting for the acquisition to be reconfigured
 
-	float *bins = samp_buf.floats;
 
-	// Convert to floats
-	for (int i = 0; i < samp_count; i++) {
-		samp_buf.floats[i] = (float)samp_buf.uints[i];
+/** Send the response to a pending datalink request, if any */
+static void dlnk_respond(uint8_t type, const void *data, size_t len)
+{
+	if (dlnk_req.type != type) return;
+
+	if (dlnk_req.skip > 0) {
+		dlnk_req.skip--;
+		return;
 	}
 
-	// normalize
-	float mean;
-	arm_mean_f32(samp_buf.floats, samp_count, &mean);
-	virt_zero_value = mean;
+	sbmp_ep_send_response(dlnk_ep, type, data, len, dlnk_req.session, NULL);
+	dlnk_req.type = 0;
+}
 
-	for (int i = 0; i < samp_count; i++) {
-		samp_buf.floats[i] -= virt_zero_value;
+
+/** Tell the peer a request can't be met, so it doesn't wait for the timeout */
+static void dlnk_refuse(uint8_t type, uint16_t session)
+{
+	sbmp_ep_send_response(dlnk_ep, DG_REQUEST_FAILED, &type, sizeof(type), session, NULL);
+}
+
+
+void audio_capture_done(void* arg)
+{
+	const uint16_t *block = arg;
+	const uint32_t start = cyc_now();
+
+	const uint32_t n = spectrum->fft_len;
+	const uint32_t hop = n / overlap;
+
+	const uint16_t *ring = block;
+	uint32_t oldest = 0;
+
+	if (overlap > 1) {
+		// only the new hop is copied, the window wraps around the ring
+		memcpy(history + history_head, block, hop * sizeof(uint16_t));
+		history_head = (history_head + hop) & (n - 1);
+
+		ring = history;
+		oldest = history_head;
+
+		// the window must hold captured samples only: nothing until the
+		// history is full, then one hop to feed the DC estimate real data
+		if (history_fill < overlap) {
+			if (++history_fill == overlap) {
+				spectrum_input(spectrum, ring, oldest, hop);
+			}
+
+			adc_block_done();
+			return;
+		}
 	}
 
+	if (oldest == 0) {
+		dlnk_respond(DG_REQUEST_RAW, ring, n * sizeof(uint16_t));
+	}
+
+	// DC removal, scaling & window in one pass
+	spectrum_input(spectrum, ring, oldest, hop);
 
 	if (print_next_fft) {
 		printf("--- Raw (adjusted) ---\n");
-		for(int i = 0; i < samp_count; i++) {
-			printf("%.2f, ", samp_buf.floats[i]);
+		for(uint32_t i = 0; i < spectrum->fft_len; i++) {
+			printf("%d, ", spectrum->samples[i]);
 		}
 		printf("\n");
 	}
 
-	for (int i = samp_count - 1; i >= 0; i--) {
-		bins[i * 2 + 1] = 0;              // imaginary
-		bins[i * 2] = samp_buf.floats[i]; // real
-	}
-
-	const arm_cfft_instance_f32 *S;
-	S = &arm_cfft_sR_f32_len128;
+	const uint16_t *bins = spectrum_fft(spectrum);
+	const uint32_t bin_count = spectrum->bin_count;
 
-	arm_cfft_f32(S, bins, 0, true); // bit reversed FFT
-	arm_cmplx_mag_f32(bins, bins, bin_count); // get magnitude (extract real values)
+	dlnk_respond(DG_REQUEST_FFT, bins, bin_count * sizeof(uint16_t));
 
 	if (print_next_fft) {
 		printf("--- Bins ---\n");
-		for(int i = 0; i < bin_count; i++) {
-			printf("%.2f, ", bins[i]);
+		for(uint32_t i = 0; i < bin_count; i++) {
+			printf("%u, ", bins[i]);
 		}
 		printf("\n");
 	}
 
-	// normalize
-	dmtx_clear(dmtx);
-	float factor = (1.0f/bin_count)*0.2f;
-	for(int i = 0; i < bin_count-1; i+=2) {
-		bins[i] *= factor;
-		bins[i+1] *= factor;
+	uint16_t band_vals[BAND_COUNT_MAX];
+	bands_reduce(bands, bins, band_vals);
 
-		//float avg = i==0 ? bins[1] : (bins[i] + bins[i+1])/2;
-		float avg = (bins[i] + bins[i+1])/2;
+	uint16_t heights[BAND_COUNT_MAX]; // 8.8 px
+	agc_process(&agc, band_vals, heights, bands->count, dmtx->rows * 8);
 
-		for(int j = 0; j < 1+floorf(avg); j++) {
-			//dmtx_toggle(dmtx, i/2, j);
-			dmtx_toggle(dmtx, i/2, j);
-			//dmtx_toggle(dmtx, j, 15-i/2);
-			//dmtx_toggle(dmtx, 15- i/2, 15-j);
-		}
+	meter_update(meter, heights);
+
+	if (!dmtx_anim_playing(&anim_player)) {
+		meter_render(meter, dmtx);
+		dmtx_sched_submit(&frame_sched);
+	}
+
+	print_next_fft = false;
+
+	proc_cycles = cyc_elapsed(start);
+	proc_cycles_max = MAX(proc_cycles_max, proc_cycles);
+
+	// ready for the next block
+	adc_block_done();
+}
+
+
+/**
+ * @brief Set up the acquisition buffers and sample rate
+ *
+ * The capture must be stopped, and no block may be waiting for
+ * processing. If the buffers don't fit in RAM or the FFT can't
+ * do the length, the previous FFT length and overlap are kept.
+ *
+ * @param fft_len : samples per FFT, see spectrum_length_ok()
+ * @param rate : sample rate, Hz
+ * @param ovl : FFTs per fft_len samples (1, 2 or 4)
+ * @return success
+ */
+static bool audio_configure(uint32_t fft_len, uint32_t rate, uint32_t ovl)
+{
+	Spectrum_Mode mode = SPECTRUM_Q15;
+	uint32_t old_len = fft_len;
+	const uint32_t old_overlap = (spectrum != NULL) ? overlap : ovl;
+
+	const uint32_t band_count = MIN(dmtx->cols * 8, BAND_COUNT_MAX);
+
+	if (spectrum != NULL) {
+		mode = spectrum->mode;
+		old_len = spectrum->fft_len;
+
+		spectrum_free(spectrum);
+		bands_free(bands);
+		free(adc_buf);
+		free(history);
+		history = NULL;
+	}
+
+	const size_t need = spectrum_mem_size(fft_len) + bands_mem_size(band_count, fft_len)
+						+ (fft_len / ovl) * 2 * sizeof(uint16_t)
+						+ ((ovl > 1) ? fft_len * sizeof(uint16_t) : 0);
+	const size_t avail = malloc_free();
+
+	bool ok = (need <= avail);
+	if (!ok) {
+		warn("FFT of %"PRIu32" needs %"PRIu32" B, %"PRIu32" B free", fft_len, (uint32_t)need, (uint32_t)avail);
+		fft_len = old_len; // its memory was just freed
+		ovl = old_overlap;
+	}
+
+	spectrum = spectrum_init(fft_len, mode);
+	if (spectrum == NULL) {
+		// the FFT can't do it, back to the previous setup
+		ok = false;
+		fft_len = old_len;
+		ovl = old_overlap;
+		spectrum = spectrum_init(fft_len, mode);
 	}
 
+	overlap = ovl;
+
+	const uint32_t hop = fft_len / overlap;
+
+	adc_buf = calloc_s(hop * 2, sizeof(uint16_t));
+
+	if (overlap > 1) {
+		history = calloc_s(fft_len, sizeof(uint16_t));
+		history_head = 0;
+		history_fill = 0;
+	}
+
+	if (ok) {
+		sample_rate = adc_set_sample_rate(rate);
+		dbg("Acquisition: %"PRIu32" samples at %"PRIu32" Hz, hop %"PRIu32, fft_len, sample_rate, hop);
+	}
+
+	proc_cycles_max = 0;
+
+	bands = bands_init(band_scale, band_count, fft_len, sample_rate, BAND_F_MIN, BAND_F_MAX);
+
+	const uint32_t frame_us = (uint32_t)((uint64_t)hop * 1000000 / sample_rate);
+	if (meter == NULL) {
+		meter = meter_init(band_count, &meter_defaults, frame_us);
+		agc_init(&agc, &agc_defaults, frame_us);
+	} else {
+		meter_set_frame_time(meter, frame_us);
+		agc_set_frame_time(&agc, frame_us);
+	}
+
+	return ok;
+}
+
+
+/** Start capturing with the current configuration */
+static void audio_start(void)
+{
+	start_adc_dma(adc_buf, spectrum->fft_len / overlap * 2);
+}
+
+
+/** Apply a new overlap (task queue, runs after the blocks already captured) */
+static void overlap_task(void *arg)
+{
+	(void)arg;
+
+	// audio_configure() frees the capture buffers, DMA must not be writing there
+	stop_adc_dma();
+
+	audio_configure(spectrum->fft_len, sample_rate, overlap_next);
+	overlap_next = 0;
+
+	audio_start();
+}
+
+
+/** Print the processing load of a hop */
+static void report_load(void)
+{
+	const uint32_t hop = spectrum->fft_len / overlap;
+	const uint32_t budget = (uint32_t)((uint64_t)hop * F_CPU / sample_rate);
+
+	dbg("Overlap %"PRIu32" %%: FFT every %"PRIu32" samples (%"PRIu32" us), load %"PRIu32" %%, max %"PRIu32" %%",
+		100 - 100 / overlap, hop, meter->frame_us,
+		proc_cycles * 100 / budget, proc_cycles_max * 100 / budget);
+}
+
+
+/** Apply a datalink request (task queue, runs after the blocks already captured) */
+static void dlnk_request_task(void *arg)
+{
+	DlnkRequest *req = arg;
+
+	// audio_configure() frees the capture buffers, DMA must not be writing there
+	stop_adc_dma();
+
+	if (audio_configure(req->count, req->rate, overlap)) {
+		dlnk_req = *req;
+	} else {
+		dlnk_refuse(req->type, req->session);
+	}
+
+	req->type = 0;
+
+	audio_start();
+}
+
+
+/** Measure the time to push a full frame, per chain and in total */
+static void bench_push(void)
+{
+	const uint32_t cyc_us = F_CPU / 1000000;
+
+	dmtx_wait(dmtx);
+	dmtx_invalidate(dmtx);
+
+	uint32_t start = cyc_now();
 	dmtx_show(dmtx);
+	uint32_t build = cyc_elapsed(start);
+	dmtx_wait(dmtx);
+	uint32_t total = cyc_elapsed(start);
+
+	dbg("Push: %"PRIu32" modules, %"PRIu32" chains, %"PRIu32" us (build %"PRIu32" us)",
+		dmtx->modules, dmtx->chain_count, total / cyc_us, build / cyc_us);
+
+	// a chain alone is what a single chain of that length would take
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		const MAX2719_Cfg *drv = &dmtx->drv[c];
+		dbg("  chain %"PRIu32": %"PRIu32" modules, DMA %"PRIu32" us, %"PRIu32" ns/module",
+			c, drv->chain_len, drv->tx_cycles / cyc_us,
+			drv->tx_cycles * 1000 / cyc_us / drv->chain_len);
+	}
+}
 
-	print_next_fft = false;
-	capture_pending = false;
+
+/** Time the sample conditioning: the former three passes vs the fused kernel */
+static void bench_input(void)
+{
+	const uint32_t n = spectrum->fft_len;
+	const uint16_t *block = (overlap > 1) ? history : adc_buf;
+	float *buf = spectrum->work;
+
+	// conversion, mean, subtraction (no window)
+	uint32_t start = cyc_now();
+	for (uint32_t i = 0; i < n; i++) {
+		buf[i] = block[i];
+	}
+	float mean;
+	arm_mean_f32(buf, n, &mean);
+	arm_offset_f32(buf, -mean, buf, n);
+	uint32_t three_pass = cyc_elapsed(start);
+
+	int32_t dc = spectrum->dc;
+	start = cyc_now();
+	spectrum_input_q15(block, 0, spectrum->samples, n, windows[spectrum->window].table, n, &dc);
+	uint32_t fused = cyc_elapsed(start);
+
+	dbg("Input, %"PRIu32" samples: 3-pass float %"PRIu32" cyc, fused q15 + %s %"PRIu32" cyc",
+		n, three_pass, windows[spectrum->window].name, fused);
 }
 
 
-static void capture_audio(void *unused)
+/** Meter tuning keys: lowercase = less, uppercase = more. False if not a meter key. */
+static bool tune_meter(uint8_t ch)
 {
-	(void)unused;
-	if (capture_pending) return;
+	Meter_Params p = meter->params;
+	uint16_t *val;
+
+	switch (ch | 0x20) {
+		case 'a': val = &p.attack_ms; break;
+		case 'r': val = &p.release_ms; break;
+		case 'h': val = &p.hold_ms; break;
+		case 'g': val = &p.gravity; break;
+		default: return false;
+	}
 
-	capture_pending = true;
+	// steps of 25 %, at least 1
+	if (ch & 0x20) {
+		*val -= MAX(1, *val / 5);
+		if (*val > 60000) *val = 0; // wrapped
+	} else {
+		*val = (uint16_t)MIN(60000, *val + MAX(1, *val / 4));
+	}
 
-	start_adc_dma(samp_buf.uints, SAMP_BUF_LEN/2);
+	meter_set_params(meter, &p);
+	meter_report(meter);
+	return true;
+}
+
+
+/** AGC tuning keys: lowercase = less, uppercase = more. False if not an AGC key. */
+static bool tune_agc(uint8_t ch)
+{
+	Agc_Params p = agc.params;
+	const int32_t dir = (ch & 0x20) ? -1 : 1;
+
+	switch (ch | 0x20) {
+		case 'n': p.floor_db = (int16_t)MIN(0, MAX(-120, p.floor_db + dir * 3)); break;
+		case 'u': p.headroom_db = (uint8_t)MIN(40, MAX(0, p.headroom_db + dir)); break;
+		case 'd': p.range_db = (uint8_t)MIN(96, MAX(6, p.range_db + dir * 3)); break;
+		case 'v': p.release_ms = (uint16_t)MIN(60000, MAX(100, p.release_ms + dir * 500)); break;
+		default: return false;
+	}
+
+	agc_set_params(&agc, &p);
+	agc_report(&agc);
+	return true;
 }
 
 
@@ -131,15 +453,97 @@ static void rx_char(ComIface *iface)
 {
 	uint8_t ch;
 	while(com_rx(iface, &ch)) {
+		if (tune_meter(ch) || tune_agc(ch)) continue;
+
 		if (ch == 'p') {
 			info("PRINT_NEXT");
 			print_next_fft = true;
 		}
+
+		if (ch == 'b') {
+			bench_push();
+		}
+
+		if (ch == 's') {
+			dmtx_sched_report(&frame_sched);
+			dbg("ADC overruns %"PRIu32, adc_overrun_count());
+			agc_report(&agc);
+			report_load();
+			dmtx_anim_report(&anim_player);
+		}
+
+		if (ch == 'x') {
+			// the player shows its frames itself, the scheduler must not swap buffers meanwhile
+			if (dmtx_anim_playing(&anim_player)) {
+				dmtx_anim_stop(&anim_player);
+				dmtx_anim_report(&anim_player);
+				dmtx_sched_start(&frame_sched, dmtx, DISPLAY_FPS);
+			} else {
+				dmtx_sched_stop(&frame_sched);
+				dmtx_anim_start(&anim_player, dmtx, &anim_demo, true);
+
+				if (!dmtx_anim_playing(&anim_player)) {
+					dmtx_sched_start(&frame_sched, dmtx, DISPLAY_FPS);
+				}
+			}
+		}
+
+		if (ch == 'f') {
+			spectrum_set_mode(spectrum, (spectrum->mode == SPECTRUM_FLOAT) ? SPECTRUM_Q15 : SPECTRUM_FLOAT);
+			spectrum_report(spectrum);
+		}
+
+		if (ch == 'w') {
+			spectrum_set_window(spectrum, (spectrum->window + 1) % WINDOW_COUNT);
+			bench_input();
+		}
+
+		if (ch == 'i') {
+			bench_input();
+		}
+
+		if (ch == 'o') {
+			// one reconfiguration at a time
+			if (overlap_next != 0 || dlnk_next.type != 0) {
+				warn("Reconfiguration already pending");
+				continue;
+			}
+
+			overlap_next = (overlap >= OVERLAP_MAX) ? 1 : overlap * 2;
+
+			// blocks already captured are processed before the buffers change
+			stop_adc_dma();
+			if (!tq_post(overlap_task, NULL)) {
+				// queued blocks still point into adc_buf, keep it
+				overlap_next = 0;
+				audio_start();
+			}
+		}
+
+		if (ch == 'l') {
+			report_load();
+		}
+
+		if (ch == 'm') {
+			// the audio task runs from the main loop too, no locking needed
+			band_scale = (band_scale + 1) % BANDS_SCALE_COUNT;
+
+			const uint32_t count = bands->count;
+			bands_free(bands);
+			bands = bands_init(band_scale, count, spectrum->fft_len, sample_rate, BAND_F_MIN, BAND_F_MAX);
+			bands_report(bands);
+		}
 	}
 }
 
 
-static task_pid_t capture_task_id;
+// 1 = all modules on SPI1, 2 = bottom row on SPI2 (sent in parallel)
+#define DISPLAY_CHAINS 1
+
+static const DotMatrix_Chain display_chains[] = {
+	{ .SPIx = SPI1, .CS_GPIOx = GPIOA, .CS_PINx = GPIO_Pin_4, .rows = 1 },
+	{ .SPIx = SPI2, .CS_GPIOx = GPIOB, .CS_PINx = GPIO_Pin_12, .rows = 1 },
+};
 
 
 int main(void)
@@ -155,20 +559,30 @@ int main(void)
 	dmtx_cfg.CS_GPIOx = GPIOA;
 	dmtx_cfg.CS_PINx = GPIO_Pin_4;
 	dmtx_cfg.SPIx = SPI1;
+	dmtx_cfg.chains = (DISPLAY_CHAINS > 1) ? display_chains : NULL;
+	dmtx_cfg.chain_count = DISPLAY_CHAINS;
 	dmtx_cfg.cols = 2;
 	dmtx_cfg.rows = 2;
+	dmtx_cfg.double_buffer = true;
+	dmtx_cfg.orientation = NULL;
 
 	dmtx = dmtx_init(&dmtx_cfg);
 
 	dmtx_intensity(dmtx, 7);
 
 	for(int i = 0; i < 16; i++) {
-		dmtx_set(dmtx, i, 0, 1);
+		dmtx_clear(dmtx);
+		dmtx_hline(dmtx, 0, 0, i+1, DMTX_OP_OR);
+		dmtx_swap(dmtx);
 		dmtx_show(dmtx);
 		delay_ms(25);
 	}
 
-	capture_task_id = add_periodic_task(capture_audio, NULL, 10, false);
+	audio_configure(FFT_LEN_DEFAULT, ADC_SAMPLE_RATE_DEFAULT, 1);
+
+	dmtx_sched_start(&frame_sched, dmtx, DISPLAY_FPS);
+
+	audio_start();
 
 	ms_time_t last;
 	while (1) {
@@ -205,5 +619,52 @@ static void poll_subsystems(void)
 
 void dlnk_rx(SBMP_Datagram *dg)
 {
-	dbg("Rx dg type %d", dg->type);
+	switch (dg->type) {
+		case DG_REQUEST_RAW:
+		case DG_REQUEST_FFT: {
+			// Sample count [u16], Frequency [u32], little endian
+			uint16_t count;
+			uint32_t rate;
+
+			if (dg->length < sizeof(count) + sizeof(rate)) {
+				warn("Dg %d too short", dg->type);
+				dlnk_refuse(dg->type, dg->session);
+				break;
+			}
+
+			memcpy(&count, dg->payload, sizeof(count));
+			memcpy(&rate, dg->payload + sizeof(count), sizeof(rate));
+
+			if (!spectrum_length_ok(count) || rate < ADC_SAMPLE_RATE_MIN || rate > ADC_SAMPLE_RATE_MAX) {
+				warn("Bad request: %"PRIu16" samples at %"PRIu32" Hz", count, rate);
+				dlnk_refuse(dg->type, dg->session);
+				break;
+			}
+
+			if (dlnk_req.type != 0 || dlnk_next.type != 0 || overlap_next != 0) {
+				warn("Request already pending");
+				dlnk_refuse(dg->type, dg->session);
+				break;
+			}
+
+			// blocks already captured are processed before the buffers change
+			stop_adc_dma();
+
+			dlnk_next.type = dg->type;
+			dlnk_next.session = dg->session;
+			dlnk_next.count = count;
+			dlnk_next.rate = rate;
+			dlnk_next.skip = 1;
+
+			if (!tq_post(dlnk_request_task, &dlnk_next)) {
+				dlnk_next.type = 0;
+				dlnk_refuse(dg->type, dg->session);
+				audio_start();
+			}
+			break;
+		}
+
+		default:
+			dbg("Rx dg type %d", dg->type);
+	}
 }
@@ -16,6 +16,7 @@
 #define STR(x) STR_HELPER(x)
 
 
-void audio_capture_done(void* unused);
+/** Process a captured block of samples (task queue, from the ADC DMA interrupt) */
+void audio_capture_done(void* block);
 
 #endif // MAIN_H
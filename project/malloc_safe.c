@@ -1,8 +1,12 @@
 #include "com/debug.h"
 
+#include "malloc_safe.h"
+
 #include <stdlib.h>
 #include <stdint.h>
 #include <inttypes.h>
+#include <malloc.h>
+#include <unistd.h>
 
 static void reset_when_done(void)
 {
@@ -38,3 +42,17 @@ void *calloc_safe_do(size_t nmemb, size_t size, const char* file, uint32_t line)
 
 	return mem;
 }
+
+
+size_t malloc_free(void)
+{
+	const char *heap_end = sbrk(0);
+	const char *stack = (const char *)__get_MSP();
+
+	size_t unused = 0;
+	if (stack > heap_end + MALLOC_STACK_RESERVE) {
+		unused = (size_t)(stack - heap_end) - MALLOC_STACK_RESERVE;
+	}
+
+	return unused + mallinfo().fordblks;
+}
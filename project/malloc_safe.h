@@ -14,4 +14,17 @@ void *calloc_safe_do(size_t nmemb, size_t size, const char* file, uint32_t line)
 #define malloc_s(size)        malloc_safe_do(size,        __FILE__, __LINE__)
 #define calloc_s(nmemb, size) calloc_safe_do(nmemb, size, __FILE__, __LINE__)
 
+/** Stack space kept out of malloc_free() */
+#define MALLOC_STACK_RESERVE 1024
+
+/**
+ * @brief Estimate how much memory can still be allocated
+ *
+ * Free heap chunks plus the space between the heap end and the stack
+ * (less MALLOC_STACK_RESERVE). Fragmentation is not accounted for.
+ *
+ * @return free bytes
+ */
+size_t malloc_free(void);
+
 #endif // MALLOC_SAFE_H
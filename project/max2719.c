@@ -1,9 +1,29 @@
 #include "max2719.h"
+#include "malloc_safe.h"
+#include "utils/cycles.h"
+
+// ---- Instances ----
+// (needed for the DMA complete interrupts)
+
+static MAX2719_Cfg *spi1_inst = NULL;
+static MAX2719_Cfg *spi2_inst = NULL;
+
+// -------------------
+
+/** Config registers kept for scrubbing, index = bit in regs_valid */
+static const MAX2719_Command scrub_cmds[MAX2719_SCRUB_REGS] = {
+	MAX2719_CMD_DECODE_MODE,
+	MAX2719_CMD_SCAN_LIMIT,
+	MAX2719_CMD_SHUTDOWN,
+	MAX2719_CMD_DISPLAY_TEST,
+	MAX2719_CMD_INTENSITY,
+};
+
 
 static inline
-void send_byte(MAX2719_Cfg *inst, uint8_t b)
+void send_frame(MAX2719_Cfg *inst, uint16_t frame)
 {
-	inst->SPIx->DR = b;
+	inst->SPIx->DR = frame;
 	while (!(inst->SPIx->SR & SPI_SR_TXE));
 }
 
@@ -21,13 +41,87 @@ void set_nss(MAX2719_Cfg *inst, bool nss)
 
 static void send_word(MAX2719_Cfg *inst, MAX2719_Command cmd, uint8_t data)
 {
-	send_byte(inst, cmd);
-	send_byte(inst, data);
+	send_frame(inst, (uint16_t)(cmd << 8) | data);
+}
+
+
+void max2719_init(MAX2719_Cfg *inst)
+{
+	IRQn_Type irqn;
+
+	inst->busy = false;
+
+	if (inst->stride == 0) {
+		inst->stride = inst->chain_len;
+	}
+
+	if (inst->SPIx == SPI1) {
+		inst->DMA_CHx = DMA1_Channel3;
+		irqn = DMA1_Channel3_IRQn;
+		spi1_inst = inst;
+	} else if (inst->SPIx == SPI2) {
+		inst->DMA_CHx = DMA1_Channel5;
+		irqn = DMA1_Channel5_IRQn;
+		spi2_inst = inst;
+	} else {
+		// no DMA - the digits will be sent using the blocking functions
+		inst->DMA_CHx = NULL;
+		return;
+	}
+
+	inst->txbuf = calloc_s(inst->chain_len * 9, sizeof(uint16_t)); // 8 digits + scrub
+
+	DMA_DeInit(inst->DMA_CHx);
+	DMA_InitTypeDef dma_cnf;
+	dma_cnf.DMA_PeripheralBaseAddr = (uint32_t)&inst->SPIx->DR;
+	dma_cnf.DMA_MemoryBaseAddr = (uint32_t)inst->txbuf;
+	dma_cnf.DMA_DIR = DMA_DIR_PeripheralDST;
+	dma_cnf.DMA_BufferSize = inst->chain_len;
+	dma_cnf.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	dma_cnf.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	dma_cnf.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+	dma_cnf.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	dma_cnf.DMA_Mode = DMA_Mode_Normal;
+	dma_cnf.DMA_Priority = DMA_Priority_Medium;
+	dma_cnf.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(inst->DMA_CHx, &dma_cnf);
+	DMA_ITConfig(inst->DMA_CHx, DMA_IT_TC, ENABLE);
+
+	SPI_I2S_DMACmd(inst->SPIx, SPI_I2S_DMAReq_Tx, ENABLE);
+	NVIC_EnableIRQ(irqn);
+}
+
+
+/** Atomically take the bus for a transfer. False if busy. */
+static bool claim(MAX2719_Cfg *inst)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	bool ok = !inst->busy;
+	if (ok) inst->busy = true;
+
+	__set_PRIMASK(primask);
+	return ok;
+}
+
+
+bool max2719_busy(MAX2719_Cfg *inst)
+{
+	return inst->busy;
+}
+
+
+void max2719_wait(MAX2719_Cfg *inst)
+{
+	while (inst->busy);
 }
 
 
 void max2719_cmd(MAX2719_Cfg *inst, uint32_t nth, MAX2719_Command cmd, uint8_t data)
 {
+	while (!claim(inst));
+
 	set_nss(inst, 0);
 	while (inst->SPIx->SR & SPI_SR_BSY);
 
@@ -41,12 +135,23 @@ void max2719_cmd(MAX2719_Cfg *inst, uint32_t nth, MAX2719_Command cmd, uint8_t d
 
 	while (inst->SPIx->SR & SPI_SR_BSY);
 	set_nss(inst, 1);
+
+	inst->busy = false;
 }
 
 
 
 void max2719_cmd_all(MAX2719_Cfg *inst, MAX2719_Command cmd, uint8_t data)
 {
+	for (uint8_t r = 0; r < MAX2719_SCRUB_REGS; r++) {
+		if (scrub_cmds[r] != cmd) continue;
+
+		inst->regs[r] = data;
+		inst->regs_valid |= 1 << r;
+	}
+
+	while (!claim(inst));
+
 	set_nss(inst, 0);
 	while (inst->SPIx->SR & SPI_SR_BSY);
 
@@ -56,11 +161,15 @@ void max2719_cmd_all(MAX2719_Cfg *inst, MAX2719_Command cmd, uint8_t data)
 
 	while (inst->SPIx->SR & SPI_SR_BSY);
 	set_nss(inst, 1);
+
+	inst->busy = false;
 }
 
 
-void max2719_cmd_all_data(MAX2719_Cfg *inst, MAX2719_Command cmd, uint8_t *data)
+void max2719_cmd_all_data(MAX2719_Cfg *inst, MAX2719_Command cmd, const uint8_t *data)
 {
+	while (!claim(inst));
+
 	set_nss(inst, 0);
 	while (inst->SPIx->SR & SPI_SR_BSY);
 
@@ -70,4 +179,194 @@ void max2719_cmd_all_data(MAX2719_Cfg *inst, MAX2719_Command cmd, uint8_t *data)
 
 	while (inst->SPIx->SR & SPI_SR_BSY);
 	set_nss(inst, 1);
+
+	inst->busy = false;
+}
+
+
+/** Start DMA of the current row (NSS goes low) */
+static void start_row(MAX2719_Cfg *inst)
+{
+	DMA_Channel_TypeDef *chan = inst->DMA_CHx;
+
+	chan->CMAR = (uint32_t)&inst->tx_stream[inst->tx_next * inst->chain_len];
+	chan->CNDTR = inst->chain_len;
+
+	set_nss(inst, 0);
+	chan->CCR |= DMA_CCR1_EN;
+}
+
+
+uint32_t max2719_build_stream(MAX2719_Cfg *inst, const uint8_t *data, uint8_t digits, uint16_t *stream)
+{
+	uint32_t rows = 0;
+
+	// last driver in the chain goes first
+	for (uint32_t d = 0; d < 8; d++) {
+		if (!(digits & (1 << d))) continue;
+
+		const uint16_t cmd = (uint16_t)((MAX2719_CMD_DIGIT0 + d) << 8);
+		const uint8_t *row = data + (d * inst->stride);
+
+		for (uint32_t i = 0; i < inst->chain_len; i++) {
+			*stream++ = cmd | row[inst->chain_len - i - 1];
+		}
+		rows++;
+	}
+
+	return rows;
+}
+
+
+bool max2719_send_stream(MAX2719_Cfg *inst, const uint16_t *stream, uint32_t rows)
+{
+	if (inst->DMA_CHx == NULL) return false;
+	if (rows == 0) return true;
+	if (!claim(inst)) return false;
+
+	inst->tx_stream = stream;
+	inst->tx_rows = rows;
+	inst->tx_next = 0;
+	inst->tx_start = cyc_now();
+
+	start_row(inst);
+	return true;
+}
+
+
+void max2719_send_digits(MAX2719_Cfg *inst, const uint8_t *data, uint8_t digits)
+{
+	if (inst->DMA_CHx == NULL) {
+		for (uint8_t i = 0; i < 8; i++) {
+			if (!(digits & (1 << i))) continue;
+			max2719_cmd_all_data(inst, MAX2719_CMD_DIGIT0+i, data + (i * inst->stride));
+		}
+		return;
+	}
+
+	max2719_wait(inst);
+
+	uint32_t rows = max2719_build_stream(inst, data, digits, inst->txbuf);
+	while (!max2719_send_stream(inst, inst->txbuf, rows));
+}
+
+
+/** Pick the config register for the next stream; NOOP if not scrubbing */
+static uint16_t scrub_word(MAX2719_Cfg *inst)
+{
+	if (!inst->scrub || inst->regs_valid == 0) return MAX2719_CMD_NOOP << 8;
+
+	uint8_t r = inst->scrub_next;
+	while (!(inst->regs_valid & (1 << r))) {
+		r = (r + 1) % MAX2719_SCRUB_REGS;
+	}
+	inst->scrub_next = (r + 1) % MAX2719_SCRUB_REGS;
+
+	return (uint16_t)(scrub_cmds[r] << 8) | inst->regs[r];
+}
+
+
+uint32_t max2719_build_sparse(MAX2719_Cfg *inst, const uint8_t *data, uint8_t *masks, uint16_t *stream)
+{
+	const uint16_t scrub = scrub_word(inst);
+	uint32_t rows = 0;
+	uint8_t pending = 0;
+
+	for (uint32_t m = 0; m < inst->chain_len; m++) {
+		pending |= masks[m];
+	}
+
+	// one changed digit of each driver per row
+	while (pending) {
+		pending = 0;
+
+		// last driver in the chain goes first
+		for (uint32_t i = 0; i < inst->chain_len; i++) {
+			const uint32_t m = inst->chain_len - i - 1;
+			const uint8_t mask = masks[m];
+
+			if (mask == 0) {
+				*stream++ = scrub; // free slot
+				continue;
+			}
+
+			const uint32_t d = (uint32_t)__builtin_ctz(mask);
+			masks[m] = mask & (mask - 1);
+			pending |= masks[m];
+
+			*stream++ = (uint16_t)((MAX2719_CMD_DIGIT0 + d) << 8) | data[d * inst->stride + m];
+		}
+		rows++;
+	}
+
+	// the busiest drivers had no free slot
+	if ((scrub >> 8) != MAX2719_CMD_NOOP && ++inst->scrub_count >= MAX2719_SCRUB_ROW_EVERY) {
+		inst->scrub_count = 0;
+
+		for (uint32_t i = 0; i < inst->chain_len; i++) {
+			*stream++ = scrub;
+		}
+		rows++;
+		inst->scrub_rows++;
+	}
+
+	return rows;
+}
+
+
+uint32_t max2719_send_sparse(MAX2719_Cfg *inst, const uint8_t *data, uint8_t *masks)
+{
+	if (inst->DMA_CHx == NULL) {
+		// no DMA - whole digit rows, blocking
+		uint8_t digits = 0;
+		for (uint32_t m = 0; m < inst->chain_len; m++) {
+			digits |= masks[m];
+			masks[m] = 0;
+		}
+
+		max2719_send_digits(inst, data, digits);
+		return (uint32_t)__builtin_popcount(digits);
+	}
+
+	max2719_wait(inst);
+
+	uint32_t rows = max2719_build_sparse(inst, data, masks, inst->txbuf);
+	while (!max2719_send_stream(inst, inst->txbuf, rows));
+
+	return rows;
+}
+
+
+/** Row sent - latch it and go on with the next one */
+static void dma_irq_base(MAX2719_Cfg *inst)
+{
+	if (inst == NULL) return;
+
+	inst->DMA_CHx->CCR &= ~DMA_CCR1_EN;
+
+	// the last frame is still being shifted out
+	while (!(inst->SPIx->SR & SPI_SR_TXE));
+	while (inst->SPIx->SR & SPI_SR_BSY);
+	set_nss(inst, 1);
+
+	if (++inst->tx_next < inst->tx_rows) {
+		start_row(inst);
+	} else {
+		inst->tx_cycles = cyc_elapsed(inst->tx_start);
+		inst->busy = false;
+	}
+}
+
+
+void DMA1_Channel3_IRQHandler(void)
+{
+	DMA_ClearITPendingBit(DMA1_IT_GL3);
+	dma_irq_base(spi1_inst);
+}
+
+
+void DMA1_Channel5_IRQHandler(void)
+{
+	DMA_ClearITPendingBit(DMA1_IT_GL5);
+	dma_irq_base(spi2_inst);
 }
@@ -3,13 +3,41 @@
 
 #include <main.h>
 
-/** Generic utilities for controlling the MAX2719 display driver */
+/** Number of config registers kept in the shadow for scrubbing */
+#define MAX2719_SCRUB_REGS 5
+
+/** Every n-th sparse stream gets an extra row re-asserting a config register in all drivers */
+#define MAX2719_SCRUB_ROW_EVERY 4
+
+/**
+ * Generic utilities for controlling the MAX2719 display driver
+ *
+ * One chain (instance) per SPI: SPI1 and SPI2 each have their own
+ * DMA channel, so two chains are sent concurrently.
+ */
 
 typedef struct {
 	SPI_TypeDef *SPIx; /*!< SPI iface used by this instance */
 	GPIO_TypeDef *CS_GPIOx; /*!< Chip select GPIO port */
 	uint16_t CS_PINx; /*!< Chip select pin mask */
 	uint32_t chain_len; /*!< Number of daisy-chained drivers (for "all" or "n-th" commands */
+	uint32_t stride; /*!< Length of a digit row in the data arrays, 0 = chain_len */
+	bool scrub; /*!< Re-assert the config registers in sparse streams, see max2719_build_sparse() */
+
+	// --- filled by max2719_init() ---
+	DMA_Channel_TypeDef *DMA_CHx; /*!< DMA channel serving the SPI Tx request */
+	uint16_t *txbuf; /*!< Prebuilt 16-bit frame stream, one row of chain_len words per latch */
+	const uint16_t *tx_stream; /*!< Stream being sent (txbuf or a caller's stream) */
+	volatile uint32_t tx_rows; /*!< Number of rows in the stream being sent */
+	volatile uint32_t tx_next; /*!< Index of the row currently being sent */
+	volatile bool busy; /*!< DMA transfer in progress */
+	uint8_t regs[MAX2719_SCRUB_REGS]; /*!< Config registers as last set by max2719_cmd_all() */
+	uint8_t regs_valid; /*!< Mask of regs set at least once */
+	uint8_t scrub_next; /*!< Index of the register to re-assert in the next stream */
+	uint8_t scrub_count; /*!< Sparse streams built, for MAX2719_SCRUB_ROW_EVERY */
+	uint32_t scrub_rows; /*!< Extra rows sent for scrubbing since init */
+	uint32_t tx_start; /*!< Cycle counter at the start of the transfer */
+	volatile uint32_t tx_cycles; /*!< Duration of the last finished DMA transfer, in CPU cycles */
 } MAX2719_Cfg;
 
 
@@ -33,6 +61,16 @@ typedef enum {
 } MAX2719_Command;
 
 
+/**
+ * @brief Set up the DMA transmit path.
+ *
+ * Must be called once the SPIx, CS, chain_len and stride fields are filled in.
+ * The SPI must be configured for 16-bit frames (MSB first).
+ *
+ * @param inst : config struct
+ */
+void max2719_init(MAX2719_Cfg *inst);
+
 /**
  * @brief Send a command to a single driver
  * @param inst : config struct
@@ -44,6 +82,8 @@ void max2719_cmd(MAX2719_Cfg *inst, uint32_t nth, MAX2719_Command cmd, uint8_t d
 
 /**
  * @brief Send command to all drivers, with the same data
+ *
+ * Config registers are remembered for scrubbing.
  * @param inst : config struct
  * @param cmd  : command
  * @param data : data byte
@@ -56,6 +96,83 @@ void max2719_cmd_all(MAX2719_Cfg *inst, MAX2719_Command cmd, uint8_t data);
  * @param cmd  : command
  * @param data : array of data bytes (must be long to cover all drivers)
  */
-void max2719_cmd_all_data(MAX2719_Cfg *inst, MAX2719_Command cmd, uint8_t *data);
+void max2719_cmd_all_data(MAX2719_Cfg *inst, MAX2719_Command cmd, const uint8_t *data);
+
+/**
+ * @brief Send digit registers of all drivers using DMA.
+ *
+ * The frame stream is built before returning, so the data array
+ * may be modified right away. NSS is latched after each digit
+ * from the DMA interrupt. Waits for a previous transfer to finish.
+ *
+ * @param inst   : config struct
+ * @param data   : digit-major array, [all DIGIT0 bytes], [all DIGIT1 bytes] ...
+ *                 rows are stride bytes apart, only the first chain_len are used
+ * @param digits : mask of digits to send, bit 0 = DIGIT0
+ */
+void max2719_send_digits(MAX2719_Cfg *inst, const uint8_t *data, uint8_t digits);
+
+/**
+ * @brief Build a stream of digit rows, as sent by max2719_send_digits()
+ * @param inst   : config struct
+ * @param data   : digit-major array, see max2719_send_digits()
+ * @param digits : mask of digits to include, bit 0 = DIGIT0
+ * @param stream : destination, must hold chain_len words for each digit included
+ * @return number of rows written
+ */
+uint32_t max2719_build_stream(MAX2719_Cfg *inst, const uint8_t *data, uint8_t digits, uint16_t *stream);
+
+/**
+ * @brief Build a stream writing only the changed digits of each driver
+ *
+ * Every latch can load a different register in each driver, so the
+ * changed digits are packed: the number of rows is the largest count
+ * of changes in a single driver, not the number of digits changed
+ * anywhere. Drivers with nothing left to write get a NOOP.
+ *
+ * With scrubbing enabled, the NOOP slots re-assert one config register
+ * (a different one in each stream), so a driver whose config got
+ * corrupted by a glitch recovers within a few frames. Every
+ * MAX2719_SCRUB_ROW_EVERY-th stream has an extra row writing the
+ * register to all drivers, reaching those that had no free slot.
+ *
+ * @param inst   : config struct
+ * @param data   : digit-major array, see max2719_send_digits()
+ * @param masks  : changed digits of each driver (bit 0 = DIGIT0), cleared while building
+ * @param stream : destination, must hold chain_len words for each row (9 rows at most)
+ * @return number of rows written
+ */
+uint32_t max2719_build_sparse(MAX2719_Cfg *inst, const uint8_t *data, uint8_t *masks, uint16_t *stream);
+
+/**
+ * @brief Send the changed digits of each driver using DMA.
+ *
+ * Like max2719_send_digits(), but the stream is built by
+ * max2719_build_sparse().
+ *
+ * @param inst  : config struct
+ * @param data  : digit-major array, see max2719_send_digits()
+ * @param masks : changed digits of each driver, cleared when done
+ * @return number of rows (latches) sent
+ */
+uint32_t max2719_send_sparse(MAX2719_Cfg *inst, const uint8_t *data, uint8_t *masks);
+
+/**
+ * @brief Send a prebuilt stream using DMA, without waiting.
+ *
+ * The stream must stay valid until the transfer ends.
+ *
+ * @param inst   : config struct
+ * @param stream : rows of chain_len words, latched one by one
+ * @param rows   : number of rows
+ * @return false if busy (nothing was sent) or there's no DMA
+ */
+bool max2719_send_stream(MAX2719_Cfg *inst, const uint16_t *stream, uint32_t rows);
+
+/** Check if a DMA transfer is in progress */
+bool max2719_busy(MAX2719_Cfg *inst);
+
+/** Wait for a DMA transfer to finish */
+void max2719_wait(MAX2719_Cfg *inst);
 
 #endif // MAX2719_H
@@ -0,0 +1,117 @@
+#include "meter.h"
+#include "malloc_safe.h"
+#include "com/debug.h"
+#include <math.h>
+
+
+uint16_t meter_coef(uint32_t tau_ms, uint32_t frame_us)
+{
+	if (tau_ms == 0) return 0xFFFF; // follow right away
+
+	const float k = 1.0f - expf(-(float)frame_us / (tau_ms * 1000.0f));
+	return (uint16_t)MIN(k * 65536.0f, 65535.0f);
+}
+
+
+static void compute_steps(Meter *mt)
+{
+	const Meter_Params *p = &mt->params;
+	const uint32_t us = mt->frame_us;
+
+	mt->k_attack = meter_coef(p->attack_ms, us);
+	mt->k_release = meter_coef(p->release_ms, us);
+	mt->hold_frames = (p->hold_ms * 1000 + us / 2) / us;
+
+	// px/s^2 -> 16.16 px/frame^2
+	const float t = us / 1e6f;
+	mt->gravity_step = (uint32_t)(p->gravity * t * t * 65536.0f + 0.5f);
+}
+
+
+Meter* meter_init(uint32_t count, const Meter_Params *params, uint32_t frame_us)
+{
+	Meter *mt = calloc_s(1, sizeof(Meter));
+
+	mt->count = count;
+	mt->bands = calloc_s(count, sizeof(Meter_Band));
+	mt->px = calloc_s(count, sizeof(uint8_t));
+	mt->params = *params;
+	mt->frame_us = frame_us;
+
+	compute_steps(mt);
+	return mt;
+}
+
+
+void meter_set_frame_time(Meter *mt, uint32_t frame_us)
+{
+	mt->frame_us = frame_us;
+	compute_steps(mt);
+}
+
+
+void meter_set_params(Meter *mt, const Meter_Params *params)
+{
+	mt->params = *params;
+	compute_steps(mt);
+}
+
+
+void meter_update(Meter *mt, const uint16_t *heights)
+{
+	for (uint32_t b = 0; b < mt->count; b++) {
+		Meter_Band *mb = &mt->bands[b];
+		const uint32_t target = (uint32_t)heights[b] << 8;
+
+		// 16.16 difference x 0.16 coefficient, in 64 bits
+		if (target > mb->level) {
+			mb->level += (uint32_t)(((uint64_t)(target - mb->level) * mt->k_attack) >> 16);
+		} else {
+			mb->level -= (uint32_t)(((uint64_t)(mb->level - target) * mt->k_release) >> 16);
+		}
+
+		// the dot catches the raw peaks, not the smoothed bar
+		if (target >= mb->peak) {
+			mb->peak = target;
+			mb->fall = 0;
+			mb->hold = mt->hold_frames;
+		} else if (mb->hold > 0) {
+			mb->hold--;
+		} else {
+			mb->fall += mt->gravity_step;
+			mb->peak = (mb->peak > mb->fall) ? mb->peak - mb->fall : 0;
+		}
+	}
+}
+
+
+void meter_render(Meter *mt, DotMatrix_Cfg *dmtx)
+{
+	const uint32_t n = MIN(mt->count, dmtx->cols * 8);
+	const uint32_t top = dmtx->rows * 8;
+
+	uint8_t *heights = mt->px;
+
+	for (uint32_t b = 0; b < n; b++) {
+		const uint32_t h = (mt->bands[b].level + 0x8000) >> 16;
+		heights[b] = (uint8_t)MAX(1, MIN(h, top));
+	}
+
+	dmtx_bars(dmtx, heights, n, DMTX_BARS_FILL);
+
+	for (uint32_t b = 0; b < n; b++) {
+		const uint32_t p = MIN((mt->bands[b].peak + 0x8000) >> 16, top);
+		if (p > heights[b]) {
+			dmtx_set(dmtx, (int32_t)b, (int32_t)p - 1, true);
+		}
+	}
+}
+
+
+void meter_report(Meter *mt)
+{
+	const Meter_Params *p = &mt->params;
+
+	dbg("Meter: attack %"PRIu16" ms, release %"PRIu16" ms, hold %"PRIu16" ms, gravity %"PRIu16" px/s2 (frame %"PRIu32" us)",
+		p->attack_ms, p->release_ms, p->hold_ms, p->gravity, mt->frame_us);
+}
@@ -0,0 +1,101 @@
+#ifndef METER_H
+#define METER_H
+
+/**
+ * Bar meter - per-band smoothing and peak-hold dots
+ *
+ * Each frame, the bar of a band moves towards its new height with a
+ * first order filter: fast on the way up (attack), slower on the way
+ * down (release). A peak dot follows the highest raw height, stays
+ * there for the hold time, then falls with constant acceleration.
+ *
+ * Heights are in pixels, 16.16 fixed point. The time constants are
+ * converted to per-frame steps by meter_set_frame_time().
+ */
+
+#include "main.h"
+#include "dotmatrix.h"
+
+/** Per-band state */
+typedef struct {
+	uint32_t level; /*!< Smoothed bar height */
+	uint32_t peak; /*!< Peak dot height */
+	uint32_t fall; /*!< Peak dot fall speed, per frame */
+	uint32_t hold; /*!< Frames left before the peak dot starts falling */
+} Meter_Band;
+
+/** Tunables, in real time units */
+typedef struct {
+	uint16_t attack_ms; /*!< Rise time constant */
+	uint16_t release_ms; /*!< Fall time constant */
+	uint16_t hold_ms; /*!< Peak hold time */
+	uint16_t gravity; /*!< Peak dot acceleration, pixels / s^2 */
+} Meter_Params;
+
+typedef struct {
+	uint32_t count; /*!< Number of bands */
+	Meter_Band *bands; /*!< Band states */
+	Meter_Params params; /*!< Tunables */
+	uint32_t frame_us; /*!< Frame period the steps are computed for */
+	uint8_t *px; /*!< Bar heights in whole pixels, for drawing */
+
+	// --- per-frame steps, from params and frame_us ---
+	uint16_t k_attack; /*!< Part of the difference taken per frame, 0.16 */
+	uint16_t k_release; /*!< Same, falling */
+	uint32_t hold_frames; /*!< Peak hold in frames */
+	uint32_t gravity_step; /*!< Peak fall speed increment per frame, 16.16 px */
+} Meter;
+
+
+/**
+ * @brief Allocate the meter
+ * @param count : number of bands
+ * @param params : tunables, copied
+ * @param frame_us : frame period, us
+ * @return the meter
+ */
+Meter* meter_init(uint32_t count, const Meter_Params *params, uint32_t frame_us);
+
+/**
+ * @brief Set the frame period (when the capture rate changes)
+ * @param mt : meter
+ * @param frame_us : frame period, us
+ */
+void meter_set_frame_time(Meter *mt, uint32_t frame_us);
+
+/**
+ * @brief Change the tunables
+ * @param mt : meter
+ * @param params : new values, copied
+ */
+void meter_set_params(Meter *mt, const Meter_Params *params);
+
+/**
+ * @brief Advance one frame
+ * @param mt : meter
+ * @param heights : new bar heights, 8.8 pixels, count values
+ */
+void meter_update(Meter *mt, const uint16_t *heights);
+
+/**
+ * @brief Draw the bars and peak dots
+ *
+ * Bars are at least 1 px high. Peak dots are drawn above the bars.
+ *
+ * @param mt : meter
+ * @param dmtx : display, one band per column
+ */
+void meter_render(Meter *mt, DotMatrix_Cfg *dmtx);
+
+/**
+ * @brief Per-frame coefficient of a first order filter
+ * @param tau_ms : time constant, ms (0 = follow right away)
+ * @param frame_us : frame period, us
+ * @return part of the difference to take each frame, 0.16
+ */
+uint16_t meter_coef(uint32_t tau_ms, uint32_t frame_us);
+
+/** Print the tunables to debug output */
+void meter_report(Meter *mt);
+
+#endif // METER_H
@@ -0,0 +1,269 @@
+#include "spectrum.h"
+#include "malloc_safe.h"
+#include "com/debug.h"
+#include "utils/cycles.h"
+
+
+bool spectrum_length_ok(uint32_t fft_len)
+{
+	if (fft_len < SPECTRUM_LEN_MIN || fft_len > SPECTRUM_LEN_MAX) return false;
+	return (fft_len & (fft_len - 1)) == 0;
+}
+
+
+/** Floats in the work buffer: the real FFT works in place, the complex one needs room for the zeros */
+static uint32_t work_len(uint32_t fft_len)
+{
+	return (fft_len < SPECTRUM_RFFT_MIN) ? fft_len * 2 : fft_len;
+}
+
+
+size_t spectrum_mem_size(uint32_t fft_len)
+{
+	// struct, samples, work, bins + 8 bytes of malloc overhead each
+	return sizeof(Spectrum) + fft_len * sizeof(q15_t) + work_len(fft_len) * sizeof(float)
+		   + fft_len / 2 * sizeof(uint16_t) + 4 * 8;
+}
+
+
+Spectrum* spectrum_init(uint32_t fft_len, Spectrum_Mode mode)
+{
+	Spectrum *sp = calloc_s(1, sizeof(Spectrum));
+
+	sp->fft_len = fft_len;
+	sp->bin_count = fft_len / 2;
+	sp->dc = SPECTRUM_ADC_MID << 16;
+	sp->window = WINDOW_HANN;
+
+	sp->samples = calloc_s(fft_len, sizeof(q15_t));
+	sp->bins = calloc_s(sp->bin_count, sizeof(uint16_t));
+
+	// float: fft_len real values (complex if zero-padded); q15: fft_len complex values
+	sp->work = calloc_s(work_len(fft_len), sizeof(float));
+
+	// the float path is the fallback, it must work
+	if (fft_len == 16) {
+		sp->cfft_f32 = &arm_cfft_sR_f32_len16;
+	} else if (arm_rfft_fast_init_f32(&sp->rfft_f32, fft_len) != ARM_MATH_SUCCESS) {
+		error("FFT length %"PRIu32" not supported", fft_len);
+		spectrum_free(sp);
+		return NULL;
+	}
+
+	sp->has_q15 = (arm_rfft_init_q15(&sp->rfft_q15, fft_len, 0, 1) == ARM_MATH_SUCCESS);
+	sp->mode = sp->has_q15 ? mode : SPECTRUM_FLOAT;
+
+	return sp;
+}
+
+
+void spectrum_free(Spectrum *sp)
+{
+	if (sp == NULL) return;
+
+	free(sp->samples);
+	free(sp->bins);
+	free(sp->work);
+	free(sp);
+}
+
+
+bool spectrum_set_mode(Spectrum *sp, Spectrum_Mode mode)
+{
+	if (mode == SPECTRUM_Q15 && !sp->has_q15) return false;
+
+	sp->mode = mode;
+	return true;
+}
+
+
+void spectrum_set_window(Spectrum *sp, Window_Type window)
+{
+	if (window < WINDOW_COUNT) sp->window = window;
+}
+
+
+void spectrum_input_q15(const uint16_t *ring, uint32_t start, q15_t *out, uint32_t n,
+						const q15_t *window, uint32_t hop, int32_t *dc)
+{
+	const uint32_t stride = WINDOW_LEN / n;
+	const uint32_t mask = n - 1;
+	int32_t acc = *dc;
+
+	for (uint32_t i = 0; i < n; i++) {
+		const int32_t x = (int32_t)ring[(start + i) & mask] << 16;
+		acc += (x - acc) >> SPECTRUM_DC_SHIFT;
+
+		// the next window starts here
+		if (i == hop - 1) *dc = acc;
+
+		// 12.16 -> 1.15, 12 bits -> 16 bits
+		int32_t s = __SSAT((x - acc) >> 12, 16);
+
+		if (window != NULL) {
+			s = (s * window_point(window, i * stride)) >> 15;
+		}
+
+		out[i] = (q15_t)s;
+	}
+}
+
+
+void spectrum_input(Spectrum *sp, const uint16_t *ring, uint32_t start, uint32_t hop)
+{
+	uint32_t t = cyc_now();
+
+	spectrum_input_q15(ring, start, sp->samples, sp->fft_len, windows[sp->window].table, hop, &sp->dc);
+
+	sp->cycles[sp->mode].input = cyc_elapsed(t);
+}
+
+
+/** Saturate a magnitude to the bin format */
+static inline uint16_t bin_sat(float m)
+{
+	return (m > 65535.0f) ? 65535 : (uint16_t)m;
+}
+
+
+/** Float complex FFT on the zero-padded input, for lengths the real FFT can't do */
+static void fft_float_padded(Spectrum *sp, Spectrum_Cycles *cyc)
+{
+	float *buf = sp->work;
+	const uint32_t n = sp->fft_len;
+
+	uint32_t start = cyc_now();
+
+	// to float, then spread out backwards in place: re, 0, re, 0...
+	arm_q15_to_float(sp->samples, buf, n);
+	for (int32_t i = (int32_t)n - 1; i >= 0; i--) {
+		buf[i * 2 + 1] = 0;
+		buf[i * 2] = buf[i];
+	}
+
+	arm_cfft_f32(sp->cfft_f32, buf, 0, true);
+
+	uint32_t mid = cyc_now();
+	cyc->fft = mid - start;
+
+	// |X| -> 2.14 units of |X|/N, window gain compensated
+	const float scale = 16384.0f / 4096 * windows[sp->window].gain_inv / n;
+
+	for (uint32_t k = 0; k < sp->bin_count; k++) {
+		const float re = buf[k * 2];
+		const float im = buf[k * 2 + 1];
+
+		float m;
+		arm_sqrt_f32(re * re + im * im, &m);
+		sp->bins[k] = bin_sat(m * scale);
+	}
+
+	cyc->mag = cyc_elapsed(mid);
+}
+
+
+/**
+ * Float real FFT
+ *
+ * The N real samples are transformed as N/2 complex values, then the
+ * split stage of arm_rfft_fast_f32() recovers the N/2 bins - fused with
+ * the magnitude, so it needs no output buffer. At N = 128 this takes
+ * about 40 % fewer cycles than the zero-padded N-point complex FFT.
+ */
+static void fft_float(Spectrum *sp, Spectrum_Cycles *cyc)
+{
+	float *buf = sp->work;
+	const uint32_t half = sp->bin_count;
+	const float *tw = sp->rfft_f32.pTwiddleRFFT;
+
+	uint32_t start = cyc_now();
+
+	arm_q15_to_float(sp->samples, buf, sp->fft_len);
+	arm_cfft_f32(&sp->rfft_f32.Sint, buf, 0, true);
+
+	uint32_t mid = cyc_now();
+	cyc->fft = mid - start;
+
+	// |X| -> 2.14 units of |X|/N, window gain compensated; the sums below are 2 * X
+	const float scale = 8192.0f / 4096 * windows[sp->window].gain_inv / sp->fft_len;
+
+	sp->bins[0] = bin_sat(fabsf(buf[0] + buf[1]) * scale * 2);
+
+	for (uint32_t k = 1; k < half; k++) {
+		const float *a = &buf[k * 2];
+		const float *b = &buf[(half - k) * 2];
+		const float tw_r = tw[k * 2];
+		const float tw_i = tw[k * 2 + 1];
+
+		const float t1a = b[0] - a[0];
+		const float t1b = b[1] + a[1];
+
+		const float re = a[0] + b[0] + tw_r * t1a + tw_i * t1b;
+		const float im = a[1] - b[1] + tw_i * t1a - tw_r * t1b;
+
+		float m;
+		arm_sqrt_f32(re * re + im * im, &m);
+		sp->bins[k] = bin_sat(m * scale);
+	}
+
+	cyc->mag = cyc_elapsed(mid);
+}
+
+
+/** q15 real FFT - the output is already scaled by 1/N */
+static void fft_q15(Spectrum *sp, Spectrum_Cycles *cyc)
+{
+	q15_t *buf = sp->work;
+
+	uint32_t start = cyc_now();
+
+	arm_rfft_q15(&sp->rfft_q15, sp->samples, buf);
+
+	uint32_t mid = cyc_now();
+	cyc->fft = mid - start;
+
+	// 1.15 complex -> 2.14 magnitude
+	arm_cmplx_mag_q15(buf, (q15_t *)sp->bins, sp->bin_count);
+
+	const uint32_t gain_inv = windows[sp->window].gain_inv;
+	if (gain_inv != 4096) {
+		for (uint32_t i = 0; i < sp->bin_count; i++) {
+			sp->bins[i] = (uint16_t)__USAT((sp->bins[i] * gain_inv) >> 12, 16);
+		}
+	}
+
+	cyc->mag = cyc_elapsed(mid);
+}
+
+
+const uint16_t* spectrum_fft(Spectrum *sp)
+{
+	Spectrum_Cycles *cyc = &sp->cycles[sp->mode];
+
+	if (sp->mode == SPECTRUM_Q15) {
+		fft_q15(sp, cyc);
+	} else if (sp->cfft_f32 != NULL) {
+		fft_float_padded(sp, cyc);
+	} else {
+		fft_float(sp, cyc);
+	}
+
+	return sp->bins;
+}
+
+
+void spectrum_report(Spectrum *sp)
+{
+	static const char *names[SPECTRUM_MODE_COUNT] = {
+		[SPECTRUM_FLOAT] = "float",
+		[SPECTRUM_Q15] = "q15",
+	};
+
+	dbg("Spectrum: %"PRIu32" samples, %s, %s window", sp->fft_len, names[sp->mode], windows[sp->window].name);
+
+	for (uint32_t m = 0; m < SPECTRUM_MODE_COUNT; m++) {
+		const Spectrum_Cycles *c = &sp->cycles[m];
+		dbg("  %-5s input %6"PRIu32", fft %7"PRIu32", mag %6"PRIu32", total %7"PRIu32" cyc",
+			names[m], c->input, c->fft, c->mag, c->input + c->fft + c->mag);
+	}
+}
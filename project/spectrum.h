@@ -0,0 +1,145 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+/**
+ * Audio spectrum pipeline
+ *
+ * ADC block -> q15 samples (DC removed, windowed) -> FFT -> bin magnitudes.
+ *
+ * The FFT runs either in float (software-emulated on the M3) or in
+ * q15 fixed point; both give the same magnitude scale, so the choice
+ * doesn't change the bars. Bin magnitudes are in 2.14 units of |X|/N:
+ * a full-scale sine gives 8192 (the window gain is compensated).
+ */
+
+#include "main.h"
+#include "arm_math.h"
+#include "window.h"
+
+/** ADC mid-scale, the initial DC estimate */
+#define SPECTRUM_ADC_MID 2048
+
+/** DC estimate time constant, 2^n samples */
+#define SPECTRUM_DC_SHIFT 10
+
+/** Bin magnitude of a full-scale sine */
+#define SPECTRUM_FULL_SCALE 8192
+
+/** FFT length limits (powers of 2); q15 needs at least 32 */
+#define SPECTRUM_LEN_MIN 16
+#define SPECTRUM_LEN_MAX 2048
+
+/** Shortest length of the float real FFT, below it a zero-padded complex FFT is used */
+#define SPECTRUM_RFFT_MIN 32
+
+typedef enum {
+	SPECTRUM_FLOAT = 0, /*!< arm_rfft_fast_f32, magnitude fused in the split stage */
+	SPECTRUM_Q15, /*!< arm_rfft_q15 + arm_cmplx_mag_q15 */
+	SPECTRUM_MODE_COUNT,
+} Spectrum_Mode;
+
+/** CPU cycles of the last run in a mode */
+typedef struct {
+	uint32_t input; /*!< Sample conditioning */
+	uint32_t fft; /*!< Transform */
+	uint32_t mag; /*!< Magnitudes, scaled to the common format */
+} Spectrum_Cycles;
+
+typedef struct {
+	Spectrum_Mode mode; /*!< FFT arithmetic */
+	uint32_t fft_len; /*!< Samples per FFT */
+	uint32_t bin_count; /*!< Output bins, fft_len / 2 */
+	Window_Type window; /*!< Window applied to the samples */
+	int32_t dc; /*!< Running DC estimate, ADC counts in 12.16 */
+	bool has_q15; /*!< The q15 FFT supports this length */
+	q15_t *samples; /*!< Conditioned input block, fft_len samples */
+	void *work; /*!< FFT work buffer, shared by the modes */
+	uint16_t *bins; /*!< Bin magnitudes, bin_count */
+	arm_rfft_instance_q15 rfft_q15; /*!< q15 real FFT */
+	arm_rfft_fast_instance_f32 rfft_f32; /*!< float real FFT */
+	const arm_cfft_instance_f32 *cfft_f32; /*!< float complex FFT of the zero-padded input, NULL if rfft_f32 is used */
+	Spectrum_Cycles cycles[SPECTRUM_MODE_COUNT]; /*!< Profiling, per mode */
+} Spectrum;
+
+
+/** Check if a FFT length is supported */
+bool spectrum_length_ok(uint32_t fft_len);
+
+/** Heap needed by spectrum_init() for a FFT length, bytes */
+size_t spectrum_mem_size(uint32_t fft_len);
+
+/**
+ * @brief Allocate the pipeline
+ *
+ * Lengths the q15 FFT can't do fall back to float.
+ *
+ * @param fft_len : FFT length, see spectrum_length_ok()
+ * @param mode : FFT arithmetic
+ * @return the instance, NULL if the float FFT can't do the length
+ */
+Spectrum* spectrum_init(uint32_t fft_len, Spectrum_Mode mode);
+
+/** Release the instance and its buffers */
+void spectrum_free(Spectrum *sp);
+
+/**
+ * @brief Select the FFT arithmetic
+ * @param sp : instance
+ * @param mode : new mode
+ * @return false if not available for this length
+ */
+bool spectrum_set_mode(Spectrum *sp, Spectrum_Mode mode);
+
+/**
+ * @brief Condition a window of ADC samples into the samples buffer
+ *
+ * The window is read from a ring of fft_len samples, oldest first.
+ * With overlapping windows, the next one starts hop samples later.
+ *
+ * @param sp : instance
+ * @param ring : fft_len raw ADC samples
+ * @param start : index of the oldest sample in the ring
+ * @param hop : samples between window starts (fft_len = no overlap)
+ */
+void spectrum_input(Spectrum *sp, const uint16_t *ring, uint32_t start, uint32_t hop);
+
+/**
+ * @brief Transform the samples buffer into bin magnitudes
+ *
+ * The samples buffer is used as scratch (its content is lost).
+ *
+ * @param sp : instance
+ * @return the bins
+ */
+const uint16_t* spectrum_fft(Spectrum *sp);
+
+/** Select the window applied by spectrum_input() */
+void spectrum_set_window(Spectrum *sp, Window_Type window);
+
+/** Print the cycle counts of both modes to debug output */
+void spectrum_report(Spectrum *sp);
+
+/**
+ * @brief Convert 12-bit ADC samples to q15, removing DC and applying a window
+ *
+ * One pass: each sample updates a running DC estimate (1st order IIR,
+ * 2^SPECTRUM_DC_SHIFT samples time constant), the estimate is
+ * subtracted, the 12-bit range is mapped to the full q15 range
+ * (saturated) and the result is multiplied by the window.
+ *
+ * Overlapping windows go through the same samples several times, so
+ * the estimate is kept as it was where the next window starts - each
+ * sample updates it once.
+ *
+ * @param ring : raw ADC samples, a ring of n
+ * @param start : index of the oldest sample in the ring
+ * @param out : q15 output, n samples
+ * @param n : number of samples, power of 2 up to WINDOW_LEN
+ * @param window : window table (see window.h), NULL for none
+ * @param hop : samples until the next window starts, 1 .. n
+ * @param dc : DC estimate, ADC counts in 12.16, updated
+ */
+void spectrum_input_q15(const uint16_t *ring, uint32_t start, q15_t *out, uint32_t n,
+						const q15_t *window, uint32_t hop, int32_t *dc);
+
+#endif // SPECTRUM_H
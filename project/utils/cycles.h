@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * CPU cycle counter (DWT CYCCNT), for profiling.
+ *
+ * Call cyc_init() once, then take the difference
+ * of two cyc_now() readings. Wraps after ~60 s at 72 MHz.
+ */
+
+#include "main.h"
+
+/** Enable the cycle counter */
+static inline void cyc_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/** Get the current cycle count */
+static inline uint32_t cyc_now(void)
+{
+	return DWT->CYCCNT;
+}
+
+/** Cycles elapsed since a cyc_now() reading */
+static inline uint32_t cyc_elapsed(uint32_t start)
+{
+	return DWT->CYCCNT - start;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * Fixed-point logarithm, for level meters (no soft-float logf).
+ *
+ * log2 in 16.16; 1 dB = LOG2FIX_DB units (20 log10 x = 6.02 log2 x).
+ */
+
+#include "main.h"
+
+/** 1 dB in 16.16 log2 units (65536 / 6.0206) */
+#define LOG2FIX_DB 10885
+
+/**
+ * @brief log2(x), 16.16 fixed point
+ *
+ * The mantissa is corrected with log2(1 + m) ~ m + 0.3466 m (1 - m),
+ * error below 0.008 (0.05 dB).
+ *
+ * @param x : value, 0 is taken as 1
+ * @return log2(x) << 16
+ */
+static inline int32_t log2fix(uint32_t x)
+{
+	if (x == 0) x = 1;
+
+	const uint32_t msb = 31 - (uint32_t)__builtin_clz(x);
+
+	// x = 2^msb * (1 + m), m in 0.16
+	const uint32_t m = ((msb >= 16) ? (x >> (msb - 16)) : (x << (16 - msb))) & 0xFFFF;
+	const uint32_t corr = (((m * (65536 - m)) >> 16) * 22713) >> 16;
+
+	return (int32_t)((msb << 16) + m + corr);
+}
@@ -0,0 +1,277 @@
+// Generated by tools/window2c.php - do not edit
+
+#include "window.h"
+
+static const q15_t hann[WINDOW_LEN / 2 + 1] = {
+	0, 0, 0, 1, 1, 2, 3, 4, 5, 6, 8, 9,
+	11, 13, 15, 17, 20, 22, 25, 28, 31, 34, 37, 41,
+	44, 48, 52, 56, 60, 65, 69, 74, 79, 84, 89, 94,
+	100, 105, 111, 117, 123, 129, 136, 142, 149, 156, 163, 170,
+	177, 185, 192, 200, 208, 216, 224, 233, 241, 250, 259, 268,
+	277, 286, 295, 305, 315, 325, 335, 345, 355, 366, 376, 387,
+	398, 409, 420, 432, 443, 455, 467, 479, 491, 503, 516, 528,
+	541, 554, 567, 580, 593, 607, 621, 634, 648, 662, 677, 691,
+	705, 720, 735, 750, 765, 780, 796, 811, 827, 843, 859, 875,
+	891, 908, 924, 941, 958, 975, 992, 1009, 1027, 1044, 1062, 1080,
+	1098, 1116, 1134, 1153, 1171, 1190, 1209, 1228, 1247, 1266, 1286, 1305,
+	1325, 1345, 1365, 1385, 1406, 1426, 1447, 1467, 1488, 1509, 1530, 1552,
+	1573, 1595, 1616, 1638, 1660, 1682, 1704, 1727, 1749, 1772, 1795, 1818,
+	1841, 1864, 1887, 1911, 1935, 1958, 1982, 2006, 2030, 2055, 2079, 2104,
+	2128, 2153, 2178, 2203, 2229, 2254, 2279, 2305, 2331, 2357, 2383, 2409,
+	2435, 2462, 2488, 2515, 2542, 2569, 2596, 2623, 2650, 2678, 2706, 2733,
+	2761, 2789, 2817, 2845, 2874, 2902, 2931, 2960, 2989, 3018, 3047, 3076,
+	3105, 3135, 3165, 3194, 3224, 3254, 3284, 3315, 3345, 3375, 3406, 3437,
+	3468, 3499, 3530, 3561, 3592, 3624, 3655, 3687, 3719, 3751, 3783, 3815,
+	3847, 3880, 3912, 3945, 3978, 4011, 4044, 4077, 4110, 4143, 4177, 4210,
+	4244, 4278, 4312, 4346, 4380, 4414, 4449, 4483, 4518, 4553, 4587, 4622,
+	4657, 4692, 4728, 4763, 4799, 4834, 4870, 4906, 4942, 4978, 5014, 5050,
+	5086, 5123, 5159, 5196, 5233, 5270, 5307, 5344, 5381, 5418, 5456, 5493,
+	5531, 5569, 5606, 5644, 5682, 5720, 5759, 5797, 5835, 5874, 5912, 5951,
+	5990, 6029, 6068, 6107, 6146, 6185, 6225, 6264, 6304, 6344, 6383, 6423,
+	6463, 6503, 6543, 6584, 6624, 6664, 6705, 6745, 6786, 6827, 6868, 6909,
+	6950, 6991, 7032, 7073, 7115, 7156, 7198, 7240, 7281, 7323, 7365, 7407,
+	7449, 7491, 7534, 7576, 7618, 7661, 7703, 7746, 7789, 7832, 7875, 7918,
+	7961, 8004, 8047, 8090, 8134, 8177, 8221, 8264, 8308, 8352, 8396, 8440,
+	8484, 8528, 8572, 8616, 8660, 8705, 8749, 8794, 8838, 8883, 8928, 8972,
+	9017, 9062, 9107, 9152, 9197, 9243, 9288, 9333, 9379, 9424, 9470, 9515,
+	9561, 9607, 9652, 9698, 9744, 9790, 9836, 9882, 9929, 9975, 10021, 10067,
+	10114, 10160, 10207, 10253, 10300, 10347, 10393, 10440, 10487, 10534, 10581, 10628,
+	10675, 10722, 10770, 10817, 10864, 10911, 10959, 11006, 11054, 11101, 11149, 11197,
+	11244, 11292, 11340, 11388, 11436, 11484, 11532, 11580, 11628, 11676, 11724, 11772,
+	11820, 11869, 11917, 11965, 12014, 12062, 12111, 12159, 12208, 12257, 12305, 12354,
+	12403, 12451, 12500, 12549, 12598, 12647, 12696, 12745, 12794, 12843, 12892, 12941,
+	12990, 13039, 13089, 13138, 13187, 13237, 13286, 13335, 13385, 13434, 13484, 13533,
+	13583, 13632, 13682, 13731, 13781, 13830, 13880, 13930, 13980, 14029, 14079, 14129,
+	14179, 14228, 14278, 14328, 14378, 14428, 14478, 14528, 14578, 14628, 14678, 14728,
+	14778, 14828, 14878, 14928, 14978, 15028, 15078, 15128, 15178, 15228, 15279, 15329,
+	15379, 15429, 15479, 15529, 15580, 15630, 15680, 15730, 15780, 15831, 15881, 15931,
+	15981, 16032, 16082, 16132, 16182, 16233, 16283, 16333, 16383, 16434, 16484, 16534,
+	16585, 16635, 16685, 16735, 16786, 16836, 16886, 16936, 16987, 17037, 17087, 17137,
+	17187, 17238, 17288, 17338, 17388, 17438, 17488, 17539, 17589, 17639, 17689, 17739,
+	17789, 17839, 17889, 17939, 17989, 18039, 18089, 18139, 18189, 18239, 18289, 18339,
+	18389, 18439, 18489, 18539, 18588, 18638, 18688, 18738, 18787, 18837, 18887, 18937,
+	18986, 19036, 19085, 19135, 19184, 19234, 19283, 19333, 19382, 19432, 19481, 19530,
+	19580, 19629, 19678, 19728, 19777, 19826, 19875, 19924, 19973, 20022, 20071, 20120,
+	20169, 20218, 20267, 20316, 20364, 20413, 20462, 20510, 20559, 20608, 20656, 20705,
+	20753, 20802, 20850, 20898, 20947, 20995, 21043, 21091, 21139, 21187, 21235, 21283,
+	21331, 21379, 21427, 21475, 21523, 21570, 21618, 21666, 21713, 21761, 21808, 21856,
+	21903, 21950, 21997, 22045, 22092, 22139, 22186, 22233, 22280, 22327, 22374, 22420,
+	22467, 22514, 22560, 22607, 22653, 22700, 22746, 22792, 22838, 22885, 22931, 22977,
+	23023, 23069, 23115, 23160, 23206, 23252, 23297, 23343, 23388, 23434, 23479, 23524,
+	23570, 23615, 23660, 23705, 23750, 23795, 23839, 23884, 23929, 23973, 24018, 24062,
+	24107, 24151, 24195, 24239, 24283, 24327, 24371, 24415, 24459, 24503, 24546, 24590,
+	24633, 24677, 24720, 24763, 24806, 24849, 24892, 24935, 24978, 25021, 25064, 25106,
+	25149, 25191, 25233, 25276, 25318, 25360, 25402, 25444, 25486, 25527, 25569, 25611,
+	25652, 25694, 25735, 25776, 25817, 25858, 25899, 25940, 25981, 26022, 26062, 26103,
+	26143, 26183, 26224, 26264, 26304, 26344, 26384, 26423, 26463, 26503, 26542, 26582,
+	26621, 26660, 26699, 26738, 26777, 26816, 26855, 26893, 26932, 26970, 27008, 27047,
+	27085, 27123, 27161, 27198, 27236, 27274, 27311, 27349, 27386, 27423, 27460, 27497,
+	27534, 27571, 27608, 27644, 27681, 27717, 27753, 27789, 27825, 27861, 27897, 27933,
+	27968, 28004, 28039, 28075, 28110, 28145, 28180, 28214, 28249, 28284, 28318, 28353,
+	28387, 28421, 28455, 28489, 28523, 28557, 28590, 28624, 28657, 28690, 28723, 28756,
+	28789, 28822, 28855, 28887, 28920, 28952, 28984, 29016, 29048, 29080, 29112, 29143,
+	29175, 29206, 29237, 29268, 29299, 29330, 29361, 29392, 29422, 29452, 29483, 29513,
+	29543, 29573, 29602, 29632, 29662, 29691, 29720, 29749, 29778, 29807, 29836, 29865,
+	29893, 29922, 29950, 29978, 30006, 30034, 30061, 30089, 30117, 30144, 30171, 30198,
+	30225, 30252, 30279, 30305, 30332, 30358, 30384, 30410, 30436, 30462, 30488, 30513,
+	30538, 30564, 30589, 30614, 30639, 30663, 30688, 30712, 30737, 30761, 30785, 30809,
+	30832, 30856, 30880, 30903, 30926, 30949, 30972, 30995, 31018, 31040, 31063, 31085,
+	31107, 31129, 31151, 31172, 31194, 31215, 31237, 31258, 31279, 31300, 31320, 31341,
+	31361, 31382, 31402, 31422, 31442, 31462, 31481, 31501, 31520, 31539, 31558, 31577,
+	31596, 31614, 31633, 31651, 31669, 31687, 31705, 31723, 31740, 31758, 31775, 31792,
+	31809, 31826, 31843, 31859, 31876, 31892, 31908, 31924, 31940, 31956, 31971, 31987,
+	32002, 32017, 32032, 32047, 32062, 32076, 32090, 32105, 32119, 32133, 32146, 32160,
+	32174, 32187, 32200, 32213, 32226, 32239, 32251, 32264, 32276, 32288, 32300, 32312,
+	32324, 32335, 32347, 32358, 32369, 32380, 32391, 32401, 32412, 32422, 32432, 32442,
+	32452, 32462, 32472, 32481, 32490, 32499, 32508, 32517, 32526, 32534, 32543, 32551,
+	32559, 32567, 32575, 32582, 32590, 32597, 32604, 32611, 32618, 32625, 32631, 32638,
+	32644, 32650, 32656, 32662, 32667, 32673, 32678, 32683, 32688, 32693, 32698, 32702,
+	32707, 32711, 32715, 32719, 32723, 32726, 32730, 32733, 32736, 32739, 32742, 32745,
+	32747, 32750, 32752, 32754, 32756, 32758, 32759, 32761, 32762, 32763, 32764, 32765,
+	32766, 32766, 32767, 32767, 32767,
+};
+
+static const q15_t hamming[WINDOW_LEN / 2 + 1] = {
+	2621, 2621, 2622, 2622, 2622, 2623, 2624, 2625, 2626, 2627, 2628, 2630,
+	2632, 2633, 2635, 2637, 2640, 2642, 2644, 2647, 2650, 2653, 2656, 2659,
+	2662, 2666, 2669, 2673, 2677, 2681, 2685, 2689, 2694, 2699, 2703, 2708,
+	2713, 2718, 2724, 2729, 2735, 2740, 2746, 2752, 2758, 2765, 2771, 2778,
+	2785, 2791, 2798, 2805, 2813, 2820, 2828, 2835, 2843, 2851, 2859, 2868,
+	2876, 2885, 2893, 2902, 2911, 2920, 2929, 2939, 2948, 2958, 2968, 2978,
+	2988, 2998, 3008, 3019, 3029, 3040, 3051, 3062, 3073, 3084, 3096, 3107,
+	3119, 3131, 3143, 3155, 3167, 3180, 3192, 3205, 3218, 3231, 3244, 3257,
+	3270, 3284, 3298, 3311, 3325, 3339, 3353, 3368, 3382, 3397, 3411, 3426,
+	3441, 3456, 3472, 3487, 3502, 3518, 3534, 3550, 3566, 3582, 3598, 3615,
+	3631, 3648, 3665, 3682, 3699, 3716, 3734, 3751, 3769, 3786, 3804, 3822,
+	3841, 3859, 3877, 3896, 3914, 3933, 3952, 3971, 3990, 4010, 4029, 4049,
+	4069, 4088, 4108, 4128, 4149, 4169, 4189, 4210, 4231, 4252, 4273, 4294,
+	4315, 4336, 4358, 4379, 4401, 4423, 4445, 4467, 4489, 4512, 4534, 4557,
+	4580, 4602, 4625, 4648, 4672, 4695, 4718, 4742, 4766, 4790, 4814, 4838,
+	4862, 4886, 4911, 4935, 4960, 4985, 5010, 5035, 5060, 5085, 5110, 5136,
+	5162, 5187, 5213, 5239, 5265, 5292, 5318, 5344, 5371, 5398, 5424, 5451,
+	5478, 5505, 5533, 5560, 5588, 5615, 5643, 5671, 5699, 5727, 5755, 5783,
+	5812, 5840, 5869, 5897, 5926, 5955, 5984, 6013, 6043, 6072, 6102, 6131,
+	6161, 6191, 6221, 6251, 6281, 6311, 6342, 6372, 6403, 6433, 6464, 6495,
+	6526, 6557, 6588, 6620, 6651, 6683, 6714, 6746, 6778, 6810, 6842, 6874,
+	6906, 6938, 6971, 7003, 7036, 7069, 7102, 7135, 7168, 7201, 7234, 7267,
+	7301, 7334, 7368, 7402, 7436, 7470, 7504, 7538, 7572, 7606, 7641, 7675,
+	7710, 7744, 7779, 7814, 7849, 7884, 7919, 7954, 7990, 8025, 8061, 8096,
+	8132, 8168, 8204, 8240, 8276, 8312, 8348, 8384, 8421, 8457, 8494, 8531,
+	8567, 8604, 8641, 8678, 8715, 8752, 8790, 8827, 8865, 8902, 8940, 8977,
+	9015, 9053, 9091, 9129, 9167, 9205, 9243, 9282, 9320, 9359, 9397, 9436,
+	9475, 9513, 9552, 9591, 9630, 9669, 9709, 9748, 9787, 9827, 9866, 9906,
+	9945, 9985, 10025, 10065, 10104, 10144, 10184, 10225, 10265, 10305, 10345, 10386,
+	10426, 10467, 10507, 10548, 10589, 10630, 10671, 10712, 10753, 10794, 10835, 10876,
+	10917, 10959, 11000, 11041, 11083, 11125, 11166, 11208, 11250, 11292, 11333, 11375,
+	11417, 11459, 11502, 11544, 11586, 11628, 11671, 11713, 11756, 11798, 11841, 11883,
+	11926, 11969, 12012, 12054, 12097, 12140, 12183, 12226, 12270, 12313, 12356, 12399,
+	12443, 12486, 12529, 12573, 12616, 12660, 12703, 12747, 12791, 12835, 12878, 12922,
+	12966, 13010, 13054, 13098, 13142, 13186, 13230, 13275, 13319, 13363, 13407, 13452,
+	13496, 13541, 13585, 13630, 13674, 13719, 13763, 13808, 13853, 13897, 13942, 13987,
+	14032, 14077, 14122, 14167, 14211, 14256, 14302, 14347, 14392, 14437, 14482, 14527,
+	14572, 14618, 14663, 14708, 14754, 14799, 14844, 14890, 14935, 14981, 15026, 15072,
+	15117, 15163, 15208, 15254, 15300, 15345, 15391, 15437, 15483, 15528, 15574, 15620,
+	15666, 15712, 15757, 15803, 15849, 15895, 15941, 15987, 16033, 16079, 16125, 16171,
+	16217, 16263, 16309, 16355, 16401, 16447, 16493, 16539, 16585, 16631, 16678, 16724,
+	16770, 16816, 16862, 16908, 16955, 17001, 17047, 17093, 17139, 17186, 17232, 17278,
+	17324, 17371, 17417, 17463, 17509, 17555, 17602, 17648, 17694, 17740, 17787, 17833,
+	17879, 17925, 17972, 18018, 18064, 18110, 18157, 18203, 18249, 18295, 18341, 18388,
+	18434, 18480, 18526, 18572, 18618, 18665, 18711, 18757, 18803, 18849, 18895, 18941,
+	18987, 19033, 19080, 19126, 19172, 19218, 19264, 19310, 19356, 19401, 19447, 19493,
+	19539, 19585, 19631, 19677, 19723, 19769, 19814, 19860, 19906, 19952, 19997, 20043,
+	20089, 20134, 20180, 20225, 20271, 20317, 20362, 20408, 20453, 20499, 20544, 20589,
+	20635, 20680, 20725, 20771, 20816, 20861, 20906, 20952, 20997, 21042, 21087, 21132,
+	21177, 21222, 21267, 21312, 21357, 21401, 21446, 21491, 21536, 21580, 21625, 21670,
+	21714, 21759, 21803, 21848, 21892, 21937, 21981, 22025, 22070, 22114, 22158, 22202,
+	22246, 22290, 22334, 22378, 22422, 22466, 22510, 22554, 22598, 22641, 22685, 22728,
+	22772, 22816, 22859, 22902, 22946, 22989, 23032, 23076, 23119, 23162, 23205, 23248,
+	23291, 23334, 23377, 23420, 23462, 23505, 23548, 23590, 23633, 23675, 23718, 23760,
+	23802, 23845, 23887, 23929, 23971, 24013, 24055, 24097, 24139, 24180, 24222, 24264,
+	24305, 24347, 24388, 24430, 24471, 24512, 24554, 24595, 24636, 24677, 24718, 24759,
+	24799, 24840, 24881, 24922, 24962, 25003, 25043, 25083, 25124, 25164, 25204, 25244,
+	25284, 25324, 25364, 25403, 25443, 25483, 25522, 25562, 25601, 25641, 25680, 25719,
+	25758, 25797, 25836, 25875, 25914, 25952, 25991, 26030, 26068, 26107, 26145, 26183,
+	26221, 26259, 26297, 26335, 26373, 26411, 26449, 26486, 26524, 26561, 26599, 26636,
+	26673, 26710, 26747, 26784, 26821, 26858, 26894, 26931, 26967, 27004, 27040, 27076,
+	27113, 27149, 27185, 27220, 27256, 27292, 27328, 27363, 27399, 27434, 27469, 27504,
+	27539, 27574, 27609, 27644, 27679, 27713, 27748, 27782, 27816, 27851, 27885, 27919,
+	27953, 27987, 28020, 28054, 28088, 28121, 28154, 28188, 28221, 28254, 28287, 28320,
+	28352, 28385, 28417, 28450, 28482, 28515, 28547, 28579, 28611, 28642, 28674, 28706,
+	28737, 28769, 28800, 28831, 28862, 28893, 28924, 28955, 28986, 29016, 29047, 29077,
+	29107, 29138, 29168, 29198, 29227, 29257, 29287, 29316, 29346, 29375, 29404, 29433,
+	29462, 29491, 29520, 29548, 29577, 29605, 29633, 29662, 29690, 29718, 29745, 29773,
+	29801, 29828, 29856, 29883, 29910, 29937, 29964, 29991, 30017, 30044, 30071, 30097,
+	30123, 30149, 30175, 30201, 30227, 30252, 30278, 30303, 30329, 30354, 30379, 30404,
+	30429, 30453, 30478, 30502, 30527, 30551, 30575, 30599, 30623, 30646, 30670, 30693,
+	30717, 30740, 30763, 30786, 30809, 30832, 30854, 30877, 30899, 30921, 30943, 30965,
+	30987, 31009, 31031, 31052, 31073, 31095, 31116, 31137, 31158, 31178, 31199, 31219,
+	31240, 31260, 31280, 31300, 31320, 31340, 31359, 31379, 31398, 31417, 31436, 31455,
+	31474, 31493, 31511, 31530, 31548, 31566, 31584, 31602, 31620, 31637, 31655, 31672,
+	31689, 31706, 31723, 31740, 31757, 31774, 31790, 31806, 31823, 31839, 31854, 31870,
+	31886, 31901, 31917, 31932, 31947, 31962, 31977, 31992, 32006, 32021, 32035, 32049,
+	32063, 32077, 32091, 32104, 32118, 32131, 32145, 32158, 32171, 32183, 32196, 32209,
+	32221, 32233, 32245, 32257, 32269, 32281, 32293, 32304, 32315, 32326, 32337, 32348,
+	32359, 32370, 32380, 32391, 32401, 32411, 32421, 32431, 32440, 32450, 32459, 32468,
+	32477, 32486, 32495, 32504, 32512, 32521, 32529, 32537, 32545, 32553, 32561, 32568,
+	32576, 32583, 32590, 32597, 32604, 32611, 32617, 32624, 32630, 32636, 32642, 32648,
+	32654, 32659, 32665, 32670, 32675, 32680, 32685, 32690, 32694, 32699, 32703, 32707,
+	32711, 32715, 32719, 32723, 32726, 32729, 32733, 32736, 32739, 32741, 32744, 32747,
+	32749, 32751, 32753, 32755, 32757, 32758, 32760, 32761, 32762, 32764, 32764, 32765,
+	32766, 32766, 32767, 32767, 32767,
+};
+
+static const q15_t blackman[WINDOW_LEN / 2 + 1] = {
+	0, 0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 3,
+	4, 5, 5, 6, 7, 8, 9, 10, 11, 12, 13, 15,
+	16, 17, 19, 20, 22, 23, 25, 27, 29, 30, 32, 34,
+	36, 38, 40, 42, 45, 47, 49, 52, 54, 57, 59, 62,
+	64, 67, 70, 73, 76, 79, 82, 85, 88, 91, 94, 98,
+	101, 105, 108, 112, 115, 119, 123, 126, 130, 134, 138, 142,
+	146, 151, 155, 159, 163, 168, 172, 177, 181, 186, 191, 196,
+	200, 205, 210, 215, 221, 226, 231, 236, 242, 247, 253, 258,
+	264, 269, 275, 281, 287, 293, 299, 305, 311, 317, 324, 330,
+	336, 343, 349, 356, 363, 369, 376, 383, 390, 397, 404, 411,
+	419, 426, 433, 441, 448, 456, 464, 472, 479, 487, 495, 503,
+	511, 520, 528, 536, 545, 553, 562, 570, 579, 588, 597, 606,
+	615, 624, 633, 642, 651, 661, 670, 680, 690, 699, 709, 719,
+	729, 739, 749, 759, 770, 780, 790, 801, 811, 822, 833, 844,
+	855, 866, 877, 888, 899, 911, 922, 934, 945, 957, 969, 981,
+	993, 1005, 1017, 1029, 1041, 1054, 1066, 1079, 1091, 1104, 1117, 1130,
+	1143, 1156, 1169, 1183, 1196, 1209, 1223, 1237, 1250, 1264, 1278, 1292,
+	1306, 1321, 1335, 1349, 1364, 1378, 1393, 1408, 1423, 1438, 1453, 1468,
+	1483, 1499, 1514, 1530, 1545, 1561, 1577, 1593, 1609, 1625, 1641, 1658,
+	1674, 1691, 1707, 1724, 1741, 1758, 1775, 1792, 1810, 1827, 1844, 1862,
+	1880, 1898, 1915, 1933, 1952, 1970, 1988, 2007, 2025, 2044, 2062, 2081,
+	2100, 2119, 2139, 2158, 2177, 2197, 2216, 2236, 2256, 2276, 2296, 2316,
+	2336, 2357, 2377, 2398, 2419, 2440, 2460, 2482, 2503, 2524, 2545, 2567,
+	2589, 2610, 2632, 2654, 2676, 2698, 2721, 2743, 2766, 2788, 2811, 2834,
+	2857, 2880, 2904, 2927, 2950, 2974, 2998, 3022, 3046, 3070, 3094, 3118,
+	3143, 3167, 3192, 3217, 3242, 3267, 3292, 3317, 3342, 3368, 3394, 3419,
+	3445, 3471, 3497, 3524, 3550, 3577, 3603, 3630, 3657, 3684, 3711, 3738,
+	3766, 3793, 3821, 3848, 3876, 3904, 3932, 3961, 3989, 4017, 4046, 4075,
+	4104, 4133, 4162, 4191, 4220, 4250, 4279, 4309, 4339, 4369, 4399, 4429,
+	4460, 4490, 4521, 4552, 4583, 4614, 4645, 4676, 4708, 4739, 4771, 4802,
+	4834, 4866, 4899, 4931, 4963, 4996, 5029, 5061, 5094, 5127, 5161, 5194,
+	5227, 5261, 5295, 5329, 5362, 5397, 5431, 5465, 5500, 5534, 5569, 5604,
+	5639, 5674, 5709, 5745, 5780, 5816, 5852, 5887, 5924, 5960, 5996, 6032,
+	6069, 6106, 6142, 6179, 6216, 6254, 6291, 6328, 6366, 6404, 6441, 6479,
+	6517, 6556, 6594, 6632, 6671, 6710, 6749, 6788, 6827, 6866, 6905, 6945,
+	6984, 7024, 7064, 7104, 7144, 7184, 7225, 7265, 7306, 7346, 7387, 7428,
+	7469, 7511, 7552, 7594, 7635, 7677, 7719, 7761, 7803, 7845, 7887, 7930,
+	7972, 8015, 8058, 8101, 8144, 8187, 8231, 8274, 8318, 8361, 8405, 8449,
+	8493, 8537, 8582, 8626, 8670, 8715, 8760, 8805, 8850, 8895, 8940, 8985,
+	9031, 9076, 9122, 9168, 9214, 9260, 9306, 9352, 9399, 9445, 9492, 9538,
+	9585, 9632, 9679, 9726, 9774, 9821, 9869, 9916, 9964, 10012, 10060, 10108,
+	10156, 10204, 10252, 10301, 10350, 10398, 10447, 10496, 10545, 10594, 10643, 10692,
+	10742, 10791, 10841, 10891, 10941, 10990, 11040, 11091, 11141, 11191, 11242, 11292,
+	11343, 11393, 11444, 11495, 11546, 11597, 11648, 11700, 11751, 11802, 11854, 11906,
+	11957, 12009, 12061, 12113, 12165, 12217, 12270, 12322, 12374, 12427, 12480, 12532,
+	12585, 12638, 12691, 12744, 12797, 12850, 12903, 12957, 13010, 13064, 13117, 13171,
+	13225, 13279, 13333, 13387, 13441, 13495, 13549, 13603, 13658, 13712, 13767, 13821,
+	13876, 13930, 13985, 14040, 14095, 14150, 14205, 14260, 14315, 14370, 14426, 14481,
+	14537, 14592, 14648, 14703, 14759, 14815, 14870, 14926, 14982, 15038, 15094, 15150,
+	15206, 15262, 15319, 15375, 15431, 15488, 15544, 15600, 15657, 15713, 15770, 15827,
+	15883, 15940, 15997, 16054, 16111, 16168, 16224, 16281, 16338, 16395, 16453, 16510,
+	16567, 16624, 16681, 16739, 16796, 16853, 16911, 16968, 17025, 17083, 17140, 17198,
+	17255, 17313, 17370, 17428, 17486, 17543, 17601, 17658, 17716, 17774, 17832, 17889,
+	17947, 18005, 18063, 18120, 18178, 18236, 18294, 18352, 18410, 18467, 18525, 18583,
+	18641, 18699, 18757, 18815, 18873, 18930, 18988, 19046, 19104, 19162, 19220, 19278,
+	19335, 19393, 19451, 19509, 19567, 19625, 19682, 19740, 19798, 19856, 19913, 19971,
+	20029, 20087, 20144, 20202, 20260, 20317, 20375, 20432, 20490, 20547, 20605, 20662,
+	20720, 20777, 20835, 20892, 20949, 21007, 21064, 21121, 21178, 21235, 21292, 21349,
+	21406, 21463, 21520, 21577, 21634, 21691, 21748, 21804, 21861, 21918, 21974, 22031,
+	22087, 22144, 22200, 22257, 22313, 22369, 22425, 22481, 22537, 22593, 22649, 22705,
+	22761, 22817, 22872, 22928, 22983, 23039, 23094, 23150, 23205, 23260, 23315, 23370,
+	23425, 23480, 23535, 23590, 23644, 23699, 23753, 23808, 23862, 23916, 23971, 24025,
+	24079, 24133, 24187, 24240, 24294, 24348, 24401, 24454, 24508, 24561, 24614, 24667,
+	24720, 24773, 24825, 24878, 24931, 24983, 25035, 25088, 25140, 25192, 25244, 25295,
+	25347, 25399, 25450, 25501, 25553, 25604, 25655, 25706, 25756, 25807, 25858, 25908,
+	25958, 26009, 26059, 26109, 26158, 26208, 26258, 26307, 26356, 26406, 26455, 26504,
+	26553, 26601, 26650, 26698, 26746, 26795, 26843, 26890, 26938, 26986, 27033, 27081,
+	27128, 27175, 27222, 27268, 27315, 27361, 27408, 27454, 27500, 27546, 27591, 27637,
+	27682, 27728, 27773, 27818, 27863, 27907, 27952, 27996, 28040, 28084, 28128, 28172,
+	28215, 28259, 28302, 28345, 28388, 28430, 28473, 28515, 28557, 28600, 28641, 28683,
+	28725, 28766, 28807, 28848, 28889, 28930, 28970, 29010, 29050, 29090, 29130, 29170,
+	29209, 29248, 29287, 29326, 29365, 29403, 29442, 29480, 29518, 29555, 29593, 29630,
+	29667, 29704, 29741, 29778, 29814, 29850, 29886, 29922, 29958, 29993, 30028, 30063,
+	30098, 30133, 30167, 30202, 30236, 30269, 30303, 30336, 30370, 30403, 30436, 30468,
+	30500, 30533, 30565, 30596, 30628, 30659, 30690, 30721, 30752, 30783, 30813, 30843,
+	30873, 30902, 30932, 30961, 30990, 31019, 31047, 31076, 31104, 31132, 31160, 31187,
+	31214, 31241, 31268, 31295, 31321, 31347, 31373, 31399, 31424, 31449, 31474, 31499,
+	31524, 31548, 31572, 31596, 31620, 31643, 31666, 31689, 31712, 31735, 31757, 31779,
+	31801, 31822, 31843, 31865, 31885, 31906, 31926, 31947, 31966, 31986, 32006, 32025,
+	32044, 32062, 32081, 32099, 32117, 32135, 32153, 32170, 32187, 32204, 32220, 32237,
+	32253, 32268, 32284, 32299, 32315, 32329, 32344, 32358, 32373, 32386, 32400, 32413,
+	32427, 32440, 32452, 32465, 32477, 32489, 32500, 32512, 32523, 32534, 32545, 32555,
+	32565, 32575, 32585, 32594, 32603, 32612, 32621, 32630, 32638, 32646, 32653, 32661,
+	32668, 32675, 32682, 32688, 32694, 32700, 32706, 32711, 32716, 32721, 32726, 32730,
+	32735, 32739, 32742, 32746, 32749, 32752, 32754, 32757, 32759, 32761, 32762, 32764,
+	32765, 32766, 32766, 32767, 32767,
+};
+
+const Window_Info windows[WINDOW_COUNT] = {
+	[WINDOW_RECT] = { "rect", NULL, 4096 },
+	[WINDOW_HANN] = { "hann", hann, 8192 },
+	[WINDOW_HAMMING] = { "hamming", hamming, 7585 },
+	[WINDOW_BLACKMAN] = { "blackman", blackman, 9752 },
+};
@@ -0,0 +1,40 @@
+#ifndef WINDOW_H
+#define WINDOW_H
+
+/**
+ * FFT window tables (generated by tools/window2c.php)
+ *
+ * Periodic windows of WINDOW_LEN points, q15. Only the first half and
+ * the middle point are stored - the rest is mirrored. A window of a
+ * shorter (power of 2) length N takes every (WINDOW_LEN / N)-th point.
+ */
+
+#include "main.h"
+#include "arm_math.h"
+
+/** Length of the full tabulated window */
+#define WINDOW_LEN 2048
+
+typedef enum {
+	WINDOW_RECT = 0, /*!< No window */
+	WINDOW_HANN,
+	WINDOW_HAMMING,
+	WINDOW_BLACKMAN,
+	WINDOW_COUNT,
+} Window_Type;
+
+typedef struct {
+	const char *name; /*!< For debug output */
+	const q15_t *table; /*!< WINDOW_LEN / 2 + 1 points, NULL = rectangular */
+	uint16_t gain_inv; /*!< 1 / coherent gain (mean of the window), 4.12 */
+} Window_Info;
+
+extern const Window_Info windows[WINDOW_COUNT];
+
+/** Point i (0 .. WINDOW_LEN - 1) of a window table */
+static inline q15_t window_point(const q15_t *table, uint32_t i)
+{
+	return table[(i <= WINDOW_LEN / 2) ? i : WINDOW_LEN - i];
+}
+
+#endif // WINDOW_H
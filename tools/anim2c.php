@@ -0,0 +1,142 @@
+#!/usr/bin/env php
+<?php
+
+// Convert a PNG sequence to a DotMatrix_Anim (see project/dotmatrix_anim.h)
+//
+// Usage: anim2c.php <name> <cols> <rows> <frame_ms> <frame.png>... > anim_name.c
+//
+// cols, rows - size of the matrix in modules (images are cols*8 x rows*8 px)
+// Pixels brighter than 50 % are lit. The C source goes to stdout,
+// the compression report to stderr.
+
+if ($argc < 6) {
+	fwrite(STDERR, "Usage: $argv[0] <name> <cols> <rows> <frame_ms> <frame.png>...\n");
+	exit(1);
+}
+
+$name = $argv[1];
+$cols = (int) $argv[2];
+$rows = (int) $argv[3];
+$frame_ms = (int) $argv[4];
+$files = array_slice($argv, 5);
+
+$modules = $cols * $rows;
+$frame_len = $modules * 8;
+
+/** Load a PNG into the digit-major screen layout */
+function load_frame($file, $cols, $rows)
+{
+	$img = imagecreatefrompng($file);
+	if (!$img) {
+		fwrite(STDERR, "Can't read $file\n");
+		exit(1);
+	}
+
+	$w = $cols * 8;
+	$h = $rows * 8;
+	if (imagesx($img) != $w || imagesy($img) != $h) {
+		fwrite(STDERR, "$file: expected {$w}x{$h} px\n");
+		exit(1);
+	}
+
+	$modules = $cols * $rows;
+	$screen = array_fill(0, $modules * 8, 0);
+
+	for ($y = 0; $y < $h; $y++) {
+		for ($x = 0; $x < $w; $x++) {
+			$c = imagecolorsforindex($img, imagecolorat($img, $x, $y));
+			$lum = ($c['red'] * 299 + $c['green'] * 587 + $c['blue'] * 114) / 1000;
+
+			if ($lum > 127) {
+				$i = ($y & 7) * $modules + ($y >> 3) * $cols + ($x >> 3);
+				$screen[$i] |= 1 << ($x & 7);
+			}
+		}
+	}
+
+	imagedestroy($img);
+	return $screen;
+}
+
+/** Run-length code a delta (XOR) array */
+function encode_delta($delta)
+{
+	$out = [];
+	$len = count($delta);
+	$i = 0;
+
+	while ($i < $len) {
+		// unchanged run
+		$n = 0;
+		while ($i + $n < $len && $delta[$i + $n] == 0 && $n < 128) $n++;
+
+		if ($n > 0) {
+			$out[] = 0x80 | ($n - 1);
+			$i += $n;
+			continue;
+		}
+
+		// literal, up to the next run of 2+ unchanged bytes
+		$n = 0;
+		while ($i + $n < $len && $n < 128) {
+			if ($delta[$i + $n] == 0 && ($i + $n + 1 >= $len || $delta[$i + $n + 1] == 0)) break;
+			$n++;
+		}
+
+		$out[] = $n - 1;
+		for ($k = 0; $k < $n; $k++) $out[] = $delta[$i + $k];
+		$i += $n;
+	}
+
+	return $out;
+}
+
+$blank = array_fill(0, $frame_len, 0);
+$prev = $blank;
+$coded = [];
+$keys = 0;
+
+foreach ($files as $idx => $file) {
+	$cur = load_frame($file, $cols, $rows);
+
+	$delta = [];
+	for ($i = 0; $i < $frame_len; $i++) $delta[] = $cur[$i] ^ $prev[$i];
+
+	$as_delta = encode_delta($delta);
+	$as_key = encode_delta($cur); // XOR with blank
+
+	// the first frame must be a key; later ones when it's shorter
+	if ($idx == 0 || count($as_key) < count($as_delta)) {
+		$coded[] = array_merge([0x01], $as_key);
+		$keys++;
+	} else {
+		$coded[] = array_merge([0x00], $as_delta);
+	}
+
+	$prev = $cur;
+}
+
+$frames = count($files);
+$raw_size = $frames * $frame_len;
+$coded_size = 0;
+
+echo "// Generated by anim2c.php - $frames frames, {$cols}x{$rows} modules\n\n";
+echo "#include \"dotmatrix_anim.h\"\n\n";
+echo "static const uint8_t {$name}_data[] = {\n";
+foreach ($coded as $idx => $frame) {
+	$coded_size += count($frame);
+	echo "\t// frame $idx" . ($frame[0] & 1 ? " (key)" : "") . "\n";
+	foreach (array_chunk($frame, 16) as $chunk) {
+		echo "\t" . implode(", ", array_map(function ($b) { return sprintf("0x%02X", $b); }, $chunk)) . ",\n";
+	}
+}
+echo "};\n\n";
+echo "const DotMatrix_Anim $name = {\n";
+echo "\t.frame_len = $frame_len,\n";
+echo "\t.frames = $frames,\n";
+echo "\t.frame_ms = $frame_ms,\n";
+echo "\t.data = {$name}_data,\n";
+echo "};\n";
+
+fprintf(STDERR, "%d frames (%d key), raw %d B, coded %d B, ratio %.2f:1\n",
+	$frames, $keys, $raw_size, $coded_size, $raw_size / max($coded_size, 1));
@@ -0,0 +1,88 @@
+#!/usr/bin/env php
+<?php
+
+// Print the display band edges for a sample rate (see project/bands.c)
+//
+// Usage: bands.php <rate> <fft_len> <bands> [log|octave|mel] [f_min] [f_max]
+//
+// Edges are snapped the way bands_init() does it: bands are at least
+// a bin wide, the outer edges fall on bin boundaries, DC is left out.
+
+if ($argc < 4) {
+	fwrite(STDERR, "Usage: $argv[0] <rate> <fft_len> <bands> [log|octave|mel] [f_min] [f_max]\n");
+	exit(1);
+}
+
+$rate = (int) $argv[1];
+$fft_len = (int) $argv[2];
+$count = (int) $argv[3];
+$scale = $argc > 4 ? $argv[4] : 'log';
+$f_min = $argc > 5 ? (float) $argv[5] : 50;
+$f_max = $argc > 6 ? (float) $argv[6] : $rate / 2;
+
+$bin_count = $fft_len / 2;
+$bin_hz = $rate / $fft_len;
+
+$f_max = min($f_max, $rate / 2);
+$f_min = max($f_min, 1);
+if ($f_max <= $f_min) $f_max = $f_min * 2;
+
+function hz_to_mel($f) { return 2595 * log10(1 + $f / 700); }
+function mel_to_hz($m) { return 700 * (pow(10, $m / 2595) - 1); }
+
+/** Frequency of edge b, as bands_edge() */
+function edge($scale, $b, $count, $f_min, $f_max)
+{
+	$t = $b / $count;
+
+	switch ($scale) {
+		case 'octave':
+			$n = max(1, floor($count / log($f_max / $f_min, 2)));
+			$j_end = floor($n * log($f_max / 1000, 2) + 0.5);
+			return 1000 * pow(2, ($j_end - $count + $b - 0.5) / $n);
+
+		case 'mel':
+			$m_min = hz_to_mel($f_min);
+			return mel_to_hz($m_min + (hz_to_mel($f_max) - $m_min) * $t);
+
+		case 'log':
+			return $f_min * pow($f_max / $f_min, $t);
+
+		default:
+			fwrite(STDERR, "Unknown scale $scale\n");
+			exit(1);
+	}
+}
+
+// edges in bins, bin k spans k-0.5 .. k+0.5
+$e = [];
+for ($b = 0; $b <= $count; $b++) {
+	$x = edge($scale, $b, $count, $f_min, $f_max) / $bin_hz;
+
+	if ($b == 0) {
+		$x = max(0.5, round($x + 0.5) - 0.5);
+	} else {
+		$x = max($x, $e[$b - 1] + 1);
+	}
+
+	if ($b == $count) $x = round($x + 0.5) - 0.5;
+	$x = min($x, $bin_count - 0.5);
+
+	$e[$b] = $x;
+}
+
+printf("%d bands (%s), %d Hz, %d-point FFT, %.1f Hz per bin\n\n", $count, $scale, $rate, $fft_len, $bin_hz);
+printf("band      from        to    bins\n");
+
+for ($b = 0; $b < $count; $b++) {
+	$lo = $e[$b];
+	$hi = $e[$b + 1];
+
+	if ($hi <= $lo) {
+		printf("%4d         -         -    (empty)\n", $b);
+		continue;
+	}
+
+	printf("%4d  %8.1f  %8.1f    %.2f (%d..%d)\n", $b, $lo * $bin_hz, $hi * $bin_hz,
+		$hi - $lo, (int) floor($lo + 0.5), (int) ceil($hi - 0.5));
+}
@@ -0,0 +1,126 @@
+/**
+ * Frame push time with the display on one driver chain against the
+ * same display split over two chains (SPI1 and SPI2, sent in parallel
+ * by DMA), swept over the number of modules.
+ *
+ * The same frames go through dmtx_show() for both layouts. The wire
+ * time of a chain is its traffic, counted by the emulator, at the SPI
+ * clock set up in hw_init.c; a frame takes as long as its slowest
+ * chain. The per-row DMA interrupt is not counted. The panel state of
+ * every chain is checked after every frame. Build and run with
+ * `make bench`.
+ */
+
+#include "dotmatrix.h"
+#include "spi_mock.h"
+#include "max7219_emu.h"
+
+#define FRAMES 64
+
+/** SPI1 (APB2 / 8) and SPI2 (APB1 / 4) both run at 9 MHz */
+#define SPI_HZ 9000000
+
+typedef struct {
+	uint32_t cols;
+	uint32_t rows;
+} Size;
+
+static const Size sizes[] = { {2, 2}, {4, 2}, {4, 4}, {8, 4}, {8, 8}, {16, 8} };
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+
+/** Diagonal stripes moving by a pixel per frame - every digit changes */
+static void draw(DotMatrix_Cfg *dmtx, uint32_t frame)
+{
+	const int32_t w = (int32_t)dmtx->cols * 8;
+	const int32_t h = (int32_t)dmtx->rows * 8;
+
+	for (int32_t y = 0; y < h; y++) {
+		for (int32_t x = 0; x < w; x++) {
+			dmtx_set(dmtx, x, y, ((x + y + (int32_t)frame) & 3) == 0);
+		}
+	}
+}
+
+
+/** Average wire time of a frame, us */
+static double run(const Size *size, uint32_t chain_count)
+{
+	const DotMatrix_Chain chains[2] = {
+		{ .SPIx = SPI1, .CS_GPIOx = GPIOA, .CS_PINx = GPIO_Pin_4, .rows = size->rows / chain_count },
+		{ .SPIx = SPI2, .CS_GPIOx = GPIOB, .CS_PINx = GPIO_Pin_12, .rows = size->rows - size->rows / chain_count },
+	};
+
+	DotMatrix_Init init = {
+		.chains = chains,
+		.chain_count = chain_count,
+		.cols = size->cols,
+		.rows = size->rows,
+	};
+
+	DotMatrix_Cfg *dmtx = dmtx_init(&init);
+	Max7219Emu *emu[DMTX_MAX_CHAINS];
+
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		emu[c] = max7219_emu_create(dmtx->drv[c].chain_len);
+		mock_replay_config(&dmtx->drv[c], emu[c]);
+	}
+
+	double total_us = 0;
+
+	for (uint32_t f = 0; f < FRAMES; f++) {
+		draw(dmtx, f);
+		dmtx_show(dmtx);
+
+		double frame_us = 0;
+
+		for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+			MAX2719_Cfg *drv = &dmtx->drv[c];
+			const uint32_t first = dmtx->chain_first[c];
+
+			max7219_emu_reset_stats(emu[c]);
+			mock_dma_run(drv, emu[c]);
+
+			const double us = emu[c]->stats.bytes * 8 * 1e6 / SPI_HZ;
+			if (us > frame_us) frame_us = us;
+
+			for (uint32_t d = 0; d < 8; d++) {
+				for (uint32_t m = 0; m < drv->chain_len; m++) {
+					if (max7219_emu_reg(emu[c], m, (uint8_t)(MAX2719_CMD_DIGIT0 + d)) != dmtx->front[d * dmtx->modules + first + m]) {
+						printf("FAIL: panel differs, %ux%u modules, chain %u of %u, frame %u\n",
+							   (unsigned)size->cols, (unsigned)size->rows, (unsigned)c,
+							   (unsigned)chain_count, (unsigned)f);
+						exit(1);
+					}
+				}
+			}
+		}
+
+		total_us += frame_us;
+	}
+
+	for (uint32_t c = 0; c < dmtx->chain_count; c++) {
+		max7219_emu_destroy(emu[c]);
+	}
+
+	return total_us / FRAMES;
+}
+
+
+int main(void)
+{
+	printf("Frame wire time, us, 1 chain / 2 chains at %d MHz (%d frames each)\n\n", SPI_HZ / 1000000, FRAMES);
+	printf("%8s %8s %10s %10s %8s\n", "modules", "layout", "1 chain", "2 chains", "speedup");
+
+	for (uint32_t s = 0; s < COUNT(sizes); s++) {
+		const double t1 = run(&sizes[s], 1);
+		const double t2 = run(&sizes[s], 2);
+
+		char layout[16];
+		snprintf(layout, sizeof(layout), "%ux%u", (unsigned)sizes[s].cols, (unsigned)sizes[s].rows);
+		printf("%8u %8s %10.1f %10.1f %7.2fx\n", (unsigned)(sizes[s].cols * sizes[s].rows), layout, t1, t2, t1 / t2);
+	}
+
+	return 0;
+}
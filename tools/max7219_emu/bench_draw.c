@@ -0,0 +1,180 @@
+/**
+ * Full-screen redraw cost: per-pixel dmtx_set() loops against the
+ * span primitives (dmtx_fill_rect(), dmtx_blit(), dmtx_hline()).
+ *
+ * Only the drawing code of dotmatrix.c is timed, with the SPI mocked.
+ * Both ways must leave the same screen array. Build and run with
+ * `make bench`.
+ */
+
+#include "dotmatrix.h"
+#include "spi_mock.h"
+#include <time.h>
+
+#define REPEAT 2000
+
+typedef struct {
+	uint32_t cols;
+	uint32_t rows;
+} Size;
+
+static const Size sizes[] = { {4, 1}, {8, 4}, {16, 8} };
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint8_t *bitmap;
+
+
+static double now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/** Checkerboard of 3x3 cells, whole screen, rows padded to bytes */
+static bool bitmap_px(int32_t x, int32_t y)
+{
+	return ((x / 3) ^ (y / 3)) & 1;
+}
+
+
+// ---- per-pixel ----
+
+static void px_fill(DotMatrix_Cfg *dmtx, int32_t w, int32_t h)
+{
+	for (int32_t y = 0; y < h; y++) {
+		for (int32_t x = 0; x < w; x++) {
+			dmtx_set(dmtx, x, y, 1);
+		}
+	}
+}
+
+
+static void px_blit(DotMatrix_Cfg *dmtx, int32_t w, int32_t h)
+{
+	const int32_t stride = (w + 7) >> 3;
+
+	for (int32_t y = 0; y < h; y++) {
+		for (int32_t x = 0; x < w; x++) {
+			dmtx_set(dmtx, x, y, (bitmap[y * stride + (x >> 3)] >> (x & 7)) & 1);
+		}
+	}
+}
+
+
+static void px_stripes(DotMatrix_Cfg *dmtx, int32_t w, int32_t h)
+{
+	for (int32_t y = 0; y < h; y++) {
+		for (int32_t x = 0; x < w; x++) {
+			dmtx_set(dmtx, x, y, !(y & 1));
+		}
+	}
+}
+
+
+// ---- spans ----
+
+static void span_fill(DotMatrix_Cfg *dmtx, int32_t w, int32_t h)
+{
+	dmtx_fill_rect(dmtx, 0, 0, w, h, DMTX_OP_COPY);
+}
+
+
+static void span_blit(DotMatrix_Cfg *dmtx, int32_t w, int32_t h)
+{
+	dmtx_blit(dmtx, bitmap, w, h, 0, 0, DMTX_OP_COPY);
+}
+
+
+static void span_stripes(DotMatrix_Cfg *dmtx, int32_t w, int32_t h)
+{
+	for (int32_t y = 0; y < h; y++) {
+		dmtx_hline(dmtx, 0, y, w, (y & 1) ? DMTX_OP_CLEAR : DMTX_OP_COPY);
+	}
+}
+
+
+typedef void (*DrawFn)(DotMatrix_Cfg *dmtx, int32_t w, int32_t h);
+
+typedef struct {
+	const char *name;
+	DrawFn per_pixel;
+	DrawFn span;
+} Case;
+
+static const Case cases[] = {
+	{ "fill", px_fill, span_fill },
+	{ "blit", px_blit, span_blit },
+	{ "hlines", px_stripes, span_stripes },
+};
+
+
+/** Average ns per redraw; the screen is cleared first each time */
+static double time_draw(DotMatrix_Cfg *dmtx, DrawFn fn, int32_t w, int32_t h)
+{
+	const double start = now_ns();
+
+	for (uint32_t i = 0; i < REPEAT; i++) {
+		dmtx_clear(dmtx);
+		fn(dmtx, w, h);
+	}
+
+	return (now_ns() - start) / REPEAT;
+}
+
+
+int main(void)
+{
+	int status = 0;
+
+	printf("Full-screen redraw, ns per frame (%d frames)\n\n", REPEAT);
+	printf("%8s %8s %10s %10s %8s\n", "screen", "draw", "per-pixel", "span", "speedup");
+
+	for (uint32_t s = 0; s < COUNT(sizes); s++) {
+		DotMatrix_Init init = {
+			.SPIx = SPI1,
+			.CS_GPIOx = GPIOA,
+			.CS_PINx = GPIO_Pin_4,
+			.cols = sizes[s].cols,
+			.rows = sizes[s].rows,
+		};
+
+		DotMatrix_Cfg *dmtx = dmtx_init(&init);
+		const int32_t w = (int32_t)init.cols * 8;
+		const int32_t h = (int32_t)init.rows * 8;
+		const uint32_t screen_len = dmtx->modules * 8;
+
+		const int32_t stride = (w + 7) >> 3;
+		bitmap = calloc((size_t)(stride * h), 1);
+		for (int32_t y = 0; y < h; y++) {
+			for (int32_t x = 0; x < w; x++) {
+				if (bitmap_px(x, y)) bitmap[y * stride + (x >> 3)] |= (uint8_t)(1 << (x & 7));
+			}
+		}
+
+		uint8_t *expected = malloc(screen_len);
+
+		for (uint32_t c = 0; c < COUNT(cases); c++) {
+			const double t_px = time_draw(dmtx, cases[c].per_pixel, w, h);
+			memcpy(expected, dmtx->screen, screen_len);
+
+			const double t_span = time_draw(dmtx, cases[c].span, w, h);
+
+			char name[16];
+			snprintf(name, sizeof(name), "%ux%u", (unsigned)w, (unsigned)h);
+			printf("%8s %8s %10.0f %10.0f %7.1fx\n", name, cases[c].name, t_px, t_span, t_px / t_span);
+
+			if (memcmp(expected, dmtx->screen, screen_len) != 0) {
+				printf("FAIL: %s differs between per-pixel and span drawing\n", cases[c].name);
+				status = 1;
+			}
+		}
+
+		free(expected);
+		free(bitmap);
+	}
+
+	return status;
+}
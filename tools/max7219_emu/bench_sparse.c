@@ -0,0 +1,108 @@
+/**
+ * Bytes per frame of the sparse update (max2719_build_sparse())
+ * against a full 8-row refresh, swept over chain length and the
+ * fraction of digits changed per frame.
+ *
+ * Traffic is counted by the emulator, the panel state is checked
+ * after every frame. Build and run with `make bench`.
+ */
+
+#include "max2719.h"
+#include "spi_mock.h"
+#include "max7219_emu.h"
+
+#define FRAMES 200
+
+static const uint32_t chain_lens[] = { 1, 2, 4, 8, 16, 32 };
+
+/** Chance of a digit changing in a frame, in 1/256 */
+static const uint32_t densities[] = { 0, 2, 8, 32, 64, 128, 256 };
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint32_t seed = 1;
+
+
+/** Deterministic LCG, 0..255 */
+static uint32_t rnd8(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) & 0xFF;
+}
+
+
+/** Average bytes per frame */
+static double run(uint32_t chain_len, uint32_t density)
+{
+	MAX2719_Cfg inst = {
+		.SPIx = SPI1,
+		.CS_GPIOx = GPIOA,
+		.CS_PINx = GPIO_Pin_4,
+		.chain_len = chain_len,
+		.scrub = true,
+	};
+
+	max2719_init(&inst);
+	max2719_cmd_all(&inst, MAX2719_CMD_SCAN_LIMIT, 0x07);
+	max2719_cmd_all(&inst, MAX2719_CMD_SHUTDOWN, 0x01);
+	max2719_cmd_all(&inst, MAX2719_CMD_INTENSITY, 0x07);
+
+	Max7219Emu *emu = max7219_emu_create(chain_len);
+	uint8_t *data = calloc(8 * chain_len, 1);
+	uint8_t *masks = calloc(chain_len, 1);
+
+	for (uint32_t f = 0; f < FRAMES; f++) {
+		for (uint32_t d = 0; d < 8; d++) {
+			for (uint32_t m = 0; m < chain_len; m++) {
+				if (rnd8() >= density) continue;
+
+				data[d * chain_len + m] ^= (uint8_t)(1 + rnd8() % 255);
+				masks[m] |= (uint8_t)(1 << d);
+			}
+		}
+
+		max2719_send_sparse(&inst, data, masks);
+		mock_dma_run(&inst, emu);
+
+		for (uint32_t i = 0; i < 8 * chain_len; i++) {
+			if (max7219_emu_reg(emu, i % chain_len, (uint8_t)(MAX2719_CMD_DIGIT0 + i / chain_len)) != data[i]) {
+				printf("FAIL: panel differs, chain %u density %u frame %u\n",
+					   (unsigned)chain_len, (unsigned)density, (unsigned)f);
+				exit(1);
+			}
+		}
+	}
+
+	const double bytes = (double)emu->stats.bytes / FRAMES;
+
+	free(inst.txbuf);
+	free(data);
+	free(masks);
+	max7219_emu_destroy(emu);
+
+	return bytes;
+}
+
+
+int main(void)
+{
+	printf("Bytes per frame, sparse / full refresh (%d frames each)\n\n", FRAMES);
+
+	printf("%8s", "chain");
+	for (uint32_t j = 0; j < COUNT(densities); j++) {
+		printf("  %6.1f%%", densities[j] * 100.0 / 256);
+	}
+	printf("  %8s\n", "full");
+
+	for (uint32_t i = 0; i < COUNT(chain_lens); i++) {
+		const uint32_t n = chain_lens[i];
+
+		printf("%8u", (unsigned)n);
+		for (uint32_t j = 0; j < COUNT(densities); j++) {
+			printf("  %7.1f", run(n, densities[j]));
+		}
+		printf("  %8u\n", (unsigned)(8 * n * 2));
+	}
+
+	return 0;
+}
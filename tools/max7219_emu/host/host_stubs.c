@@ -0,0 +1,55 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+/*
+ * malloc_safe.c and com/debug.c for host builds
+ */
+
+void *malloc_safe_do(size_t size, const char* file, uint32_t line)
+{
+	void *p = malloc(size);
+	if (p == NULL) {
+		fprintf(stderr, "%s:%u: malloc failed\n", file, (unsigned)line);
+		abort();
+	}
+	return p;
+}
+
+
+void *calloc_safe_do(size_t nmemb, size_t size, const char* file, uint32_t line)
+{
+	void *p = calloc(nmemb, size);
+	if (p == NULL) {
+		fprintf(stderr, "%s:%u: calloc failed\n", file, (unsigned)line);
+		abort();
+	}
+	return p;
+}
+
+
+static void print_tagged(const char *tag, const char *fmt, va_list va)
+{
+	fputs(tag, stderr);
+	vfprintf(stderr, fmt, va);
+	fputc('\n', stderr);
+}
+
+
+void warn(const char *fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	print_tagged("[W] ", fmt, va);
+	va_end(va);
+}
+
+
+void error(const char *fmt, ...)
+{
+	va_list va;
+	va_start(va, fmt);
+	print_tagged("[E] ", fmt, va);
+	va_end(va);
+}
@@ -0,0 +1,134 @@
+#include "spi_mock.h"
+#include <stdlib.h>
+#include <string.h>
+
+SPI_TypeDef mock_spi1 = { .SR = SPI_SR_TXE };
+SPI_TypeDef mock_spi2 = { .SR = SPI_SR_TXE };
+GPIO_TypeDef mock_gpioa = { .ODR = 0xFFFF }; // chip selects idle high
+GPIO_TypeDef mock_gpiob = { .ODR = 0xFFFF };
+DMA_Channel_TypeDef mock_dma1_ch3;
+DMA_Channel_TypeDef mock_dma1_ch5;
+CoreDebug_Type mock_core_debug;
+DWT_Type mock_dwt;
+
+Mock_Log mock_log;
+
+void DMA1_Channel3_IRQHandler(void);
+void DMA1_Channel5_IRQHandler(void);
+
+/** Config registers in the order max2719.c keeps them */
+static const MAX2719_Command config_cmds[MAX2719_SCRUB_REGS] = {
+	MAX2719_CMD_DECODE_MODE,
+	MAX2719_CMD_SCAN_LIMIT,
+	MAX2719_CMD_SHUTDOWN,
+	MAX2719_CMD_DISPLAY_TEST,
+	MAX2719_CMD_INTENSITY,
+};
+
+
+static void fail(const char *msg)
+{
+	fprintf(stderr, "spi_mock: %s\n", msg);
+	abort();
+}
+
+
+static void log_event(Mock_EventKind kind, uint16_t word)
+{
+	if (mock_log.count < MOCK_LOG_LEN) {
+		mock_log.events[mock_log.count] = (Mock_Event) { kind, word };
+	}
+	mock_log.count++;
+}
+
+
+void mock_log_reset(void)
+{
+	mock_log.count = 0;
+}
+
+
+/** Apply the pending BSRR/BRR writes to the chip select, in the driver's order */
+static void update_nss(MAX2719_Cfg *inst, Max7219Emu *emu)
+{
+	GPIO_TypeDef *gpio = inst->CS_GPIOx;
+	const uint16_t pin = inst->CS_PINx;
+
+	// the IRQ handler raises NSS before starting the next row
+	if (gpio->BSRR & pin) {
+		gpio->BSRR &= ~(uint32_t)pin;
+
+		if (!(gpio->ODR & pin)) {
+			gpio->ODR |= pin;
+			log_event(MOCK_NSS_HIGH, 0);
+			if (emu != NULL) max7219_emu_load(emu, true);
+		}
+	}
+
+	if (gpio->BRR & pin) {
+		gpio->BRR &= ~(uint32_t)pin;
+
+		if (gpio->ODR & pin) {
+			gpio->ODR &= ~(uint32_t)pin;
+			log_event(MOCK_NSS_LOW, 0);
+			if (emu != NULL) max7219_emu_load(emu, false);
+		}
+	}
+}
+
+
+uint32_t mock_dma_run(MAX2719_Cfg *inst, Max7219Emu *emu)
+{
+	void (*irq)(void) = (inst->SPIx == SPI1) ? DMA1_Channel3_IRQHandler : DMA1_Channel5_IRQHandler;
+	DMA_Channel_TypeDef *chan = inst->DMA_CHx;
+	GPIO_TypeDef *gpio = inst->CS_GPIOx;
+	uint32_t rows = 0;
+
+	// pulses of the blocking functions (low, then high) carried no DMA
+	// data; a started transfer leaves NSS low
+	gpio->BSRR &= ~(uint32_t)inst->CS_PINx;
+	if (!inst->busy) {
+		gpio->BRR &= ~(uint32_t)inst->CS_PINx;
+		return 0;
+	}
+
+	while (inst->busy) {
+		update_nss(inst, emu);
+
+		if (chan == NULL || !(chan->CCR & DMA_CCR1_EN)) fail("busy, but the DMA channel is not enabled");
+		if (gpio->ODR & inst->CS_PINx) fail("DMA enabled with NSS high");
+		if (chan->CNDTR != inst->chain_len) fail("row length differs from the chain length");
+
+		// CMAR is 32 bits, the host pointer may be wider
+		const uint16_t *row = &inst->tx_stream[inst->tx_next * inst->chain_len];
+		if (chan->CMAR != (uint32_t)(uintptr_t)row) fail("DMA memory address is not the current row");
+
+		for (uint32_t i = 0; i < chan->CNDTR; i++) {
+			log_event(MOCK_WORD, row[i]);
+			if (emu != NULL) max7219_emu_word(emu, row[i]);
+		}
+		chan->CNDTR = 0;
+
+		irq();
+		rows++;
+	}
+
+	update_nss(inst, emu);
+	if (!(gpio->ODR & inst->CS_PINx)) fail("NSS left low after the transfer");
+
+	return rows;
+}
+
+
+void mock_replay_config(MAX2719_Cfg *inst, Max7219Emu *emu)
+{
+	for (uint32_t r = 0; r < MAX2719_SCRUB_REGS; r++) {
+		if (!(inst->regs_valid & (1 << r))) continue;
+
+		max7219_emu_load(emu, false);
+		for (uint32_t i = 0; i < inst->chain_len; i++) {
+			max7219_emu_word(emu, (uint16_t)(config_cmds[r] << 8) | inst->regs[r]);
+		}
+		max7219_emu_load(emu, true);
+	}
+}
@@ -0,0 +1,67 @@
+#ifndef SPI_MOCK_H
+#define SPI_MOCK_H
+
+/**
+ * Host mock of the SPI Tx DMA and chip select used by max2719.c.
+ *
+ * mock_dma_run() does what the DMA controller and its interrupt do on
+ * the target: it moves each row the driver programmed into the channel
+ * to the emulated chain, then calls the DMA IRQ handler, which raises
+ * NSS and starts the next row. Every NSS edge and word is logged, so
+ * tests can check the exact wire sequence.
+ *
+ * Nothing runs in the background: a transfer started by the driver
+ * stays busy (and max2719_wait() spins) until mock_dma_run() is called.
+ * Words sent with the blocking functions (max2719_cmd_all() etc.)
+ * go straight to the data register and are not seen by the mock.
+ */
+
+#include "max2719.h"
+#include "max7219_emu.h"
+
+/** Wire event kinds in the log */
+typedef enum {
+	MOCK_NSS_LOW,
+	MOCK_WORD,
+	MOCK_NSS_HIGH,
+} Mock_EventKind;
+
+typedef struct {
+	Mock_EventKind kind;
+	uint16_t word; /*!< Frame, for MOCK_WORD */
+} Mock_Event;
+
+/** Max events kept in the log, the rest is counted only */
+#define MOCK_LOG_LEN 4096
+
+typedef struct {
+	Mock_Event events[MOCK_LOG_LEN];
+	uint32_t count; /*!< Events logged (may exceed MOCK_LOG_LEN) */
+} Mock_Log;
+
+extern Mock_Log mock_log;
+
+/** Clear the wire log */
+void mock_log_reset(void);
+
+/**
+ * @brief Complete the DMA transfer in progress on a chain
+ *
+ * Checks that the channel is set up for each row and NSS is low
+ * while it is sent. Aborts the program on a protocol violation.
+ *
+ * @param inst : driver chain
+ * @param emu : emulated chain receiving the words, may be NULL
+ * @return number of rows transferred
+ */
+uint32_t mock_dma_run(MAX2719_Cfg *inst, Max7219Emu *emu);
+
+/**
+ * @brief Bring an emulated chain to the state max2719_cmd_all() sets up
+ *
+ * The blocking commands bypass the mock, this replays the
+ * config registers the driver remembers for scrubbing.
+ */
+void mock_replay_config(MAX2719_Cfg *inst, Max7219Emu *emu);
+
+#endif // SPI_MOCK_H
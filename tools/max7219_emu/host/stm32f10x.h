@@ -0,0 +1,115 @@
+#ifndef HOST_STM32F10X_H
+#define HOST_STM32F10X_H
+
+/**
+ * Host stand-in for the device header, just enough to build the
+ * MAX2719 and dot matrix drivers on a PC.
+ *
+ * The peripherals are plain structs in RAM; spi_mock.c plays the
+ * DMA controller and the chip select, see spi_mock.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+	DISABLE = 0,
+	ENABLE = !DISABLE
+} FunctionalState;
+
+typedef enum {
+	DMA1_Channel3_IRQn = 13,
+	DMA1_Channel5_IRQn = 15,
+} IRQn_Type;
+
+typedef struct {
+	volatile uint16_t SR;
+	volatile uint16_t DR;
+} SPI_TypeDef;
+
+typedef struct {
+	volatile uint32_t ODR; /*!< Pin levels, updated by the mock from BSRR/BRR */
+	volatile uint32_t BSRR;
+	volatile uint32_t BRR;
+} GPIO_TypeDef;
+
+typedef struct {
+	volatile uint32_t CCR;
+	volatile uint32_t CNDTR;
+	volatile uint32_t CPAR;
+	volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+	uint32_t DMA_PeripheralBaseAddr;
+	uint32_t DMA_MemoryBaseAddr;
+	uint32_t DMA_DIR;
+	uint32_t DMA_BufferSize;
+	uint32_t DMA_PeripheralInc;
+	uint32_t DMA_MemoryInc;
+	uint32_t DMA_PeripheralDataSize;
+	uint32_t DMA_MemoryDataSize;
+	uint32_t DMA_Mode;
+	uint32_t DMA_Priority;
+	uint32_t DMA_M2M;
+} DMA_InitTypeDef;
+
+extern SPI_TypeDef mock_spi1, mock_spi2;
+extern GPIO_TypeDef mock_gpioa, mock_gpiob;
+extern DMA_Channel_TypeDef mock_dma1_ch3, mock_dma1_ch5;
+extern CoreDebug_Type mock_core_debug;
+extern DWT_Type mock_dwt;
+
+#define SPI1 (&mock_spi1)
+#define SPI2 (&mock_spi2)
+#define GPIOA (&mock_gpioa)
+#define GPIOB (&mock_gpiob)
+#define DMA1_Channel3 (&mock_dma1_ch3)
+#define DMA1_Channel5 (&mock_dma1_ch5)
+#define CoreDebug (&mock_core_debug)
+#define DWT (&mock_dwt)
+
+#define SPI_SR_TXE ((uint16_t)0x0002)
+#define SPI_SR_BSY ((uint16_t)0x0080)
+#define DMA_CCR1_EN ((uint32_t)0x00000001)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+
+#define GPIO_Pin_4 ((uint16_t)0x0010)
+#define GPIO_Pin_12 ((uint16_t)0x1000)
+
+// register values are irrelevant here, the mock does not decode them
+#define DMA_DIR_PeripheralDST 0
+#define DMA_PeripheralInc_Disable 0
+#define DMA_MemoryInc_Enable 0
+#define DMA_PeripheralDataSize_HalfWord 0
+#define DMA_MemoryDataSize_HalfWord 0
+#define DMA_Mode_Normal 0
+#define DMA_Priority_Medium 0
+#define DMA_M2M_Disable 0
+#define DMA_IT_TC 0
+#define DMA1_IT_GL3 0
+#define DMA1_IT_GL5 0
+#define SPI_I2S_DMAReq_Tx 0
+
+static inline void DMA_DeInit(DMA_Channel_TypeDef *ch) { ch->CCR = 0; }
+static inline void DMA_Init(DMA_Channel_TypeDef *ch, DMA_InitTypeDef *cnf) { ch->CPAR = cnf->DMA_PeripheralBaseAddr; }
+static inline void DMA_ITConfig(DMA_Channel_TypeDef *ch, uint32_t it, FunctionalState st) { (void)ch; (void)it; (void)st; }
+static inline void DMA_ClearITPendingBit(uint32_t it) { (void)it; }
+static inline void SPI_I2S_DMACmd(SPI_TypeDef *spi, uint16_t req, FunctionalState st) { (void)spi; (void)req; (void)st; }
+static inline void NVIC_EnableIRQ(IRQn_Type irqn) { (void)irqn; }
+
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) {}
+
+#endif // HOST_STM32F10X_H
@@ -0,0 +1,170 @@
+#include "max7219_emu.h"
+#include <stdlib.h>
+#include <string.h>
+
+// register addresses
+#define REG_NOOP 0x00
+#define REG_DIGIT0 0x01
+#define REG_INTENSITY 0x0A
+#define REG_SCAN_LIMIT 0x0B
+#define REG_SHUTDOWN 0x0C
+#define REG_DISPLAY_TEST 0x0F
+
+
+Max7219Emu* max7219_emu_create(uint32_t modules)
+{
+	Max7219Emu *emu = calloc(1, sizeof(Max7219Emu));
+	if (emu == NULL) return NULL;
+
+	emu->modules = modules;
+	emu->shift = calloc(modules, sizeof(uint16_t));
+	emu->regs = calloc(modules, sizeof(*emu->regs));
+	emu->load = true;
+
+	if (emu->shift == NULL || emu->regs == NULL) {
+		max7219_emu_destroy(emu);
+		return NULL;
+	}
+
+	return emu;
+}
+
+
+void max7219_emu_destroy(Max7219Emu *emu)
+{
+	if (emu == NULL) return;
+
+	free(emu->shift);
+	free(emu->regs);
+	free(emu);
+}
+
+
+void max7219_emu_byte(Max7219Emu *emu, uint8_t byte)
+{
+	emu->stats.bytes++;
+
+	for (int32_t b = 7; b >= 0; b--) {
+		uint16_t in = (byte >> b) & 1;
+
+		// DOUT of each module feeds DIN of the next one
+		for (uint32_t m = 0; m < emu->modules; m++) {
+			uint16_t out = emu->shift[m] >> 15;
+			emu->shift[m] = (uint16_t)(emu->shift[m] << 1) | in;
+			in = out;
+		}
+	}
+}
+
+
+void max7219_emu_word(Max7219Emu *emu, uint16_t word)
+{
+	max7219_emu_byte(emu, (uint8_t)(word >> 8));
+	max7219_emu_byte(emu, (uint8_t)word);
+}
+
+
+void max7219_emu_load(Max7219Emu *emu, bool level)
+{
+	if (level && !emu->load) {
+		emu->stats.latches++;
+
+		for (uint32_t m = 0; m < emu->modules; m++) {
+			uint8_t addr = (emu->shift[m] >> 8) & 0x0F;
+
+			if (addr == REG_NOOP) {
+				emu->stats.noops++;
+			} else {
+				emu->regs[m][addr] = (uint8_t)emu->shift[m];
+				emu->stats.writes++;
+			}
+		}
+	}
+
+	emu->load = level;
+}
+
+
+void max7219_emu_stream(Max7219Emu *emu, const uint16_t *stream, uint32_t rows)
+{
+	for (uint32_t r = 0; r < rows; r++) {
+		max7219_emu_load(emu, false);
+
+		for (uint32_t i = 0; i < emu->modules; i++) {
+			max7219_emu_word(emu, *stream++);
+		}
+
+		max7219_emu_load(emu, true);
+	}
+}
+
+
+uint8_t max7219_emu_reg(const Max7219Emu *emu, uint32_t module, uint8_t addr)
+{
+	if (module >= emu->modules) return 0;
+
+	return emu->regs[module][addr & 0x0F];
+}
+
+
+bool max7219_emu_pixel(const Max7219Emu *emu, uint32_t cols, uint32_t x, uint32_t y)
+{
+	uint32_t m = (y >> 3) * cols + (x >> 3);
+	if ((x >> 3) >= cols || m >= emu->modules) return false;
+
+	const uint8_t *regs = emu->regs[m];
+	uint8_t digit = y & 7;
+
+	if (regs[REG_DISPLAY_TEST] & 1) return true;
+	if (!(regs[REG_SHUTDOWN] & 1)) return false;
+	if (digit > (regs[REG_SCAN_LIMIT] & 7)) return false;
+
+	return (regs[REG_DIGIT0 + digit] >> (x & 7)) & 1;
+}
+
+
+void max7219_emu_print(const Max7219Emu *emu, uint32_t cols, FILE *fp)
+{
+	const uint32_t w = cols * 8;
+	const uint32_t h = ((emu->modules + cols - 1) / cols) * 8;
+
+	for (uint32_t y = 0; y < h; y++) {
+		for (uint32_t x = 0; x < w; x++) {
+			fputc(max7219_emu_pixel(emu, cols, x, y) ? '#' : '.', fp);
+		}
+		fputc('\n', fp);
+	}
+}
+
+
+void max7219_emu_ppm(const Max7219Emu *emu, uint32_t cols, FILE *fp)
+{
+	const uint32_t w = cols * 8;
+	const uint32_t h = ((emu->modules + cols - 1) / cols) * 8;
+
+	fprintf(fp, "P6\n%u %u\n255\n", (unsigned)w, (unsigned)h);
+
+	for (uint32_t y = 0; y < h; y++) {
+		for (uint32_t x = 0; x < w; x++) {
+			uint8_t px[3] = {0x10, 0, 0}; // unlit - dark red
+
+			if (max7219_emu_pixel(emu, cols, x, y)) {
+				uint32_t m = (y >> 3) * cols + (x >> 3);
+				uint8_t intensity = emu->regs[m][REG_INTENSITY] & 0x0F;
+
+				if (emu->regs[m][REG_DISPLAY_TEST] & 1) intensity = 0x0F; // test is full brightness
+
+				px[0] = (uint8_t)(0x40 + intensity * 0x0C);
+				px[1] = (uint8_t)(intensity * 0x04);
+			}
+
+			fwrite(px, 1, 3, fp);
+		}
+	}
+}
+
+
+void max7219_emu_reset_stats(Max7219Emu *emu)
+{
+	memset(&emu->stats, 0, sizeof(Max7219Emu_Stats));
+}
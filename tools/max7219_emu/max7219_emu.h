@@ -0,0 +1,101 @@
+#ifndef MAX7219_EMU_H
+#define MAX7219_EMU_H
+
+/**
+ * Host-side emulator of a MAX7219 daisy chain.
+ *
+ * Feed it what the driver puts on the wire - SPI bytes (or 16-bit
+ * words, MSB first) and the NSS/LOAD level - and it models the chain
+ * as one long shift register: each module passes the bits falling out
+ * of its 16-bit register on to the next one, and the rising edge of
+ * LOAD latches every module's register at once. The panel state can
+ * then be rendered as ASCII art or a PPM image, and the traffic
+ * counters tell how much a driver change costs on the wire.
+ *
+ * Module 0 is the one wired to the MCU (the first module of the
+ * dotmatrix screen layout). BCD decode mode is not emulated - digit
+ * registers are always shown as raw segment/column bits.
+ *
+ * Builds with any C99 compiler; not part of the firmware.
+ * `make test` in this directory runs the driver's stream builders
+ * (project/max2719.c, with SPI/DMA mocked in host/) through it.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef struct {
+	uint32_t bytes; /*!< Bytes shifted in */
+	uint32_t latches; /*!< LOAD rising edges */
+	uint32_t writes; /*!< Register writes (latched words other than NOOP) */
+	uint32_t noops; /*!< Latched NOOP words */
+} Max7219Emu_Stats;
+
+typedef struct {
+	uint32_t modules; /*!< Chain length */
+	uint16_t *shift; /*!< Shift register of each module */
+	uint8_t (*regs)[16]; /*!< Register file of each module, indexed by address */
+	bool load; /*!< Current LOAD (NSS) level */
+	Max7219Emu_Stats stats;
+} Max7219Emu;
+
+
+/**
+ * @brief Create a chain in the power-up state (shutdown, all registers 0)
+ * @param modules : number of modules
+ * @return the emulator, NULL if out of memory
+ */
+Max7219Emu* max7219_emu_create(uint32_t modules);
+
+/** Free the emulator */
+void max7219_emu_destroy(Max7219Emu *emu);
+
+/** Shift a byte into the chain, MSB first */
+void max7219_emu_byte(Max7219Emu *emu, uint8_t byte);
+
+/** Shift a 16-bit frame into the chain, as sent by a 16-bit SPI */
+void max7219_emu_word(Max7219Emu *emu, uint16_t word);
+
+/** Set the LOAD (NSS) level; the rising edge latches all modules */
+void max7219_emu_load(Max7219Emu *emu, bool level);
+
+/**
+ * @brief Send a row stream as built by max2719_build_stream()
+ *
+ * Each row of `modules` words is shifted in and latched.
+ *
+ * @param emu : emulator
+ * @param stream : rows of 16-bit frames
+ * @param rows : number of rows
+ */
+void max7219_emu_stream(Max7219Emu *emu, const uint16_t *stream, uint32_t rows);
+
+/** Read a register of a module */
+uint8_t max7219_emu_reg(const Max7219Emu *emu, uint32_t module, uint8_t addr);
+
+/**
+ * @brief Get the visible state of a pixel
+ *
+ * Takes shutdown, display test and scan limit into account.
+ * The layout is that of the dotmatrix driver: modules row by row,
+ * `cols` modules wide, bit (x & 7) of digit (y & 7).
+ *
+ * @param emu : emulator
+ * @param cols : modules per row
+ * @param x : pixel X
+ * @param y : pixel Y
+ * @return true if lit
+ */
+bool max7219_emu_pixel(const Max7219Emu *emu, uint32_t cols, uint32_t x, uint32_t y);
+
+/** Print the panel as ASCII art, '#' = lit */
+void max7219_emu_print(const Max7219Emu *emu, uint32_t cols, FILE *fp);
+
+/** Write the panel as a binary PPM, lit pixels shaded by the intensity register */
+void max7219_emu_ppm(const Max7219Emu *emu, uint32_t cols, FILE *fp);
+
+/** Clear the traffic counters */
+void max7219_emu_reset_stats(Max7219Emu *emu);
+
+#endif // MAX7219_EMU_H
@@ -0,0 +1,195 @@
+/**
+ * Drives the real max2719.c stream builders through the mock DMA
+ * into the emulator and checks the resulting panel state.
+ *
+ * Build and run with `make test`.
+ */
+
+#include "max2719.h"
+#include "spi_mock.h"
+#include "max7219_emu.h"
+
+#define CHAIN_LEN 4
+
+static uint32_t failures;
+
+#define check(cond, ...) do { \
+		if (!(cond)) { \
+			printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+
+static void chain_init(MAX2719_Cfg *inst)
+{
+	*inst = (MAX2719_Cfg) {
+		.SPIx = SPI1,
+		.CS_GPIOx = GPIOA,
+		.CS_PINx = GPIO_Pin_4,
+		.chain_len = CHAIN_LEN,
+		.scrub = true,
+	};
+
+	max2719_init(inst);
+
+	max2719_cmd_all(inst, MAX2719_CMD_DECODE_MODE, 0x00);
+	max2719_cmd_all(inst, MAX2719_CMD_SCAN_LIMIT, 0x07);
+	max2719_cmd_all(inst, MAX2719_CMD_SHUTDOWN, 0x01);
+	max2719_cmd_all(inst, MAX2719_CMD_DISPLAY_TEST, 0x00);
+	max2719_cmd_all(inst, MAX2719_CMD_INTENSITY, 0x07);
+}
+
+
+/** All digit registers of the chain match the data array */
+static bool digits_match(const Max7219Emu *emu, const uint8_t *data)
+{
+	for (uint32_t d = 0; d < 8; d++) {
+		for (uint32_t m = 0; m < CHAIN_LEN; m++) {
+			if (max7219_emu_reg(emu, m, MAX2719_CMD_DIGIT0 + d) != data[d * CHAIN_LEN + m]) return false;
+		}
+	}
+	return true;
+}
+
+
+static void print_stats(const char *what, const Max7219Emu *emu)
+{
+	printf("%-12s %4u bytes, %3u latches, %4u writes, %3u noops\n", what,
+		   (unsigned)emu->stats.bytes, (unsigned)emu->stats.latches,
+		   (unsigned)emu->stats.writes, (unsigned)emu->stats.noops);
+}
+
+
+static void test_full_frame(MAX2719_Cfg *inst)
+{
+	Max7219Emu *emu = max7219_emu_create(CHAIN_LEN);
+	mock_replay_config(inst, emu);
+	max7219_emu_reset_stats(emu);
+
+	// a diagonal in each module, shifted by the module index
+	uint8_t data[8 * CHAIN_LEN];
+	for (uint32_t d = 0; d < 8; d++) {
+		for (uint32_t m = 0; m < CHAIN_LEN; m++) {
+			data[d * CHAIN_LEN + m] = (uint8_t)(1 << ((d + m) & 7));
+		}
+	}
+
+	max2719_send_digits(inst, data, 0xFF);
+	const uint32_t rows = mock_dma_run(inst, emu);
+
+	check(rows == 8, "full frame sent %u rows", (unsigned)rows);
+	check(digits_match(emu, data), "digit registers differ after a full frame");
+
+	for (uint32_t y = 0; y < 8; y++) {
+		for (uint32_t x = 0; x < CHAIN_LEN * 8; x++) {
+			const bool lit = ((x & 7) == ((y + (x >> 3)) & 7));
+			check(max7219_emu_pixel(emu, CHAIN_LEN, x, y) == lit, "pixel %u,%u", (unsigned)x, (unsigned)y);
+		}
+	}
+
+	check(emu->stats.bytes == 8 * CHAIN_LEN * 2, "full frame took %u bytes", (unsigned)emu->stats.bytes);
+	check(emu->stats.latches == 8, "full frame took %u latches", (unsigned)emu->stats.latches);
+	check(emu->stats.noops == 0, "full frame sent %u noops", (unsigned)emu->stats.noops);
+
+	print_stats("full frame", emu);
+	max7219_emu_print(emu, CHAIN_LEN, stdout);
+	max7219_emu_destroy(emu);
+}
+
+
+static void test_sparse(MAX2719_Cfg *inst)
+{
+	Max7219Emu *emu = max7219_emu_create(CHAIN_LEN);
+	mock_replay_config(inst, emu);
+
+	uint8_t data[8 * CHAIN_LEN] = {0};
+	uint8_t masks[CHAIN_LEN] = {0};
+
+	// start from a known frame
+	for (uint32_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 37);
+	max2719_send_digits(inst, data, 0xFF);
+	mock_dma_run(inst, emu);
+	max7219_emu_reset_stats(emu);
+
+	// module 1: three digits, module 3: one digit, the rest unchanged
+	data[0 * CHAIN_LEN + 1] ^= 0x81;
+	data[4 * CHAIN_LEN + 1] ^= 0x18;
+	data[7 * CHAIN_LEN + 1] ^= 0xFF;
+	data[2 * CHAIN_LEN + 3] ^= 0x3C;
+	masks[1] = (1 << 0) | (1 << 4) | (1 << 7);
+	masks[3] = (1 << 2);
+
+	const uint32_t rows = max2719_send_sparse(inst, data, masks);
+	const uint32_t sent = mock_dma_run(inst, emu);
+
+	check(rows == sent, "send_sparse() returned %u rows, %u sent", (unsigned)rows, (unsigned)sent);
+	check(rows == 3 || rows == 4, "sparse update took %u rows, expected 3 (+1 scrub)", (unsigned)rows);
+	check(masks[1] == 0 && masks[3] == 0, "masks not cleared");
+	check(digits_match(emu, data), "digit registers differ after a sparse update");
+
+	print_stats("sparse", emu);
+	max7219_emu_destroy(emu);
+}
+
+
+static void test_scrub(MAX2719_Cfg *inst)
+{
+	// a chain that lost its config (power-up state: shutdown, scan limit 0)
+	Max7219Emu *emu = max7219_emu_create(CHAIN_LEN);
+
+	uint8_t data[8 * CHAIN_LEN] = {0};
+	uint8_t masks[CHAIN_LEN] = {0};
+	uint32_t scrub_rows = inst->scrub_rows;
+
+	// module 0 changes every frame, the others only get scrub words
+	for (uint32_t f = 0; f < 4 * MAX2719_SCRUB_REGS; f++) {
+		data[(f & 7) * CHAIN_LEN] ^= 1;
+		masks[0] = (uint8_t)(1 << (f & 7));
+
+		max2719_send_sparse(inst, data, masks);
+		mock_dma_run(inst, emu);
+	}
+
+	scrub_rows = inst->scrub_rows - scrub_rows;
+	check(scrub_rows == MAX2719_SCRUB_REGS, "%u extra scrub rows", (unsigned)scrub_rows);
+
+	static const MAX2719_Command regs[] = {
+		MAX2719_CMD_DECODE_MODE, MAX2719_CMD_SCAN_LIMIT, MAX2719_CMD_SHUTDOWN,
+		MAX2719_CMD_DISPLAY_TEST, MAX2719_CMD_INTENSITY,
+	};
+	static const uint8_t want[] = { 0x00, 0x07, 0x01, 0x00, 0x07 };
+
+	for (uint32_t m = 0; m < CHAIN_LEN; m++) {
+		for (uint32_t r = 0; r < MAX2719_SCRUB_REGS; r++) {
+			const uint8_t v = max7219_emu_reg(emu, m, regs[r]);
+			check(v == want[r], "module %u register 0x%02X is 0x%02X", (unsigned)m, regs[r], v);
+		}
+	}
+
+	check(digits_match(emu, data), "digit registers differ after scrubbing");
+
+	print_stats("scrub", emu);
+	max7219_emu_destroy(emu);
+}
+
+
+int main(void)
+{
+	MAX2719_Cfg inst;
+	chain_init(&inst);
+
+	test_full_frame(&inst);
+	test_sparse(&inst);
+	test_scrub(&inst);
+
+	if (failures) {
+		printf("%u check(s) failed\n", (unsigned)failures);
+		return 1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
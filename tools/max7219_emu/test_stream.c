@@ -0,0 +1,152 @@
+/**
+ * Checks the exact wire sequence of the DMA digit streams
+ * (max2719_build_stream() / max2719_send_stream() / the DMA IRQ):
+ * 16-bit frames of each row, last driver first, and NSS pulsed
+ * once per row.
+ *
+ * Build and run with `make test`.
+ */
+
+#include "max2719.h"
+#include "spi_mock.h"
+
+#define CHAIN_LEN 3
+#define STRIDE 5
+
+static uint32_t failures;
+
+#define check(cond, ...) do { \
+		if (!(cond)) { \
+			printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+
+/** Expected log of a row stream: per row NSS low, the words, NSS high */
+static uint32_t expect_rows(Mock_Event *ev, const uint8_t *data, uint8_t digits)
+{
+	uint32_t n = 0;
+
+	for (uint32_t d = 0; d < 8; d++) {
+		if (!(digits & (1 << d))) continue;
+
+		ev[n++] = (Mock_Event) { MOCK_NSS_LOW, 0 };
+		for (uint32_t i = 0; i < CHAIN_LEN; i++) {
+			const uint8_t byte = data[d * STRIDE + (CHAIN_LEN - i - 1)];
+			ev[n++] = (Mock_Event) { MOCK_WORD, (uint16_t)(((MAX2719_CMD_DIGIT0 + d) << 8) | byte) };
+		}
+		ev[n++] = (Mock_Event) { MOCK_NSS_HIGH, 0 };
+	}
+
+	return n;
+}
+
+
+static void check_log(const Mock_Event *want, uint32_t count)
+{
+	check(mock_log.count == count, "%u wire events, expected %u", (unsigned)mock_log.count, (unsigned)count);
+
+	for (uint32_t i = 0; i < count && i < mock_log.count; i++) {
+		const Mock_Event *got = &mock_log.events[i];
+		check(got->kind == want[i].kind && got->word == want[i].word,
+			  "event %u: kind %d word 0x%04X, expected kind %d word 0x%04X",
+			  (unsigned)i, got->kind, got->word, want[i].kind, want[i].word);
+	}
+}
+
+
+static void test_build(MAX2719_Cfg *inst, const uint8_t *data)
+{
+	uint16_t stream[8 * CHAIN_LEN];
+
+	const uint32_t rows = max2719_build_stream(inst, data, 0x81, stream);
+	check(rows == 2, "built %u rows for 2 digits", (unsigned)rows);
+
+	// DIGIT0, then DIGIT7; the last driver's byte goes out first
+	static const uint16_t want[] = {
+		0x0102, 0x0101, 0x0100,
+		0x0872, 0x0871, 0x0870,
+	};
+
+	for (uint32_t i = 0; i < 2 * CHAIN_LEN; i++) {
+		check(stream[i] == want[i], "word %u is 0x%04X, expected 0x%04X", (unsigned)i, stream[i], want[i]);
+	}
+}
+
+
+static void test_send(MAX2719_Cfg *inst, const uint8_t *data)
+{
+	Mock_Event want[8 * (CHAIN_LEN + 2)];
+
+	// all digits
+	mock_log_reset();
+	max2719_send_digits(inst, data, 0xFF);
+	check(max2719_busy(inst), "not busy after starting a transfer");
+	check(mock_dma_run(inst, NULL) == 8, "full frame not sent as 8 rows");
+	check(!max2719_busy(inst), "still busy after the last row");
+	check_log(want, expect_rows(want, data, 0xFF));
+
+	// some digits
+	mock_log_reset();
+	max2719_send_digits(inst, data, 0x24);
+	check(mock_dma_run(inst, NULL) == 2, "2 digits not sent as 2 rows");
+	check_log(want, expect_rows(want, data, 0x24));
+}
+
+
+static void test_busy(MAX2719_Cfg *inst, const uint8_t *data)
+{
+	uint16_t stream[8 * CHAIN_LEN];
+	const uint32_t rows = max2719_build_stream(inst, data, 0x03, stream);
+
+	mock_log_reset();
+	check(max2719_send_stream(inst, stream, rows), "send_stream() refused an idle chain");
+	check(!max2719_send_stream(inst, stream, rows), "send_stream() accepted a busy chain");
+	check(mock_dma_run(inst, NULL) == rows, "stream not sent whole");
+
+	Mock_Event want[2 * (CHAIN_LEN + 2)];
+	check_log(want, expect_rows(want, data, 0x03));
+
+	// nothing to send - no NSS pulse
+	mock_log_reset();
+	check(max2719_send_stream(inst, stream, 0), "empty stream refused");
+	check(!max2719_busy(inst), "busy after an empty stream");
+	check(mock_log.count == 0, "empty stream produced %u wire events", (unsigned)mock_log.count);
+}
+
+
+int main(void)
+{
+	MAX2719_Cfg inst = {
+		.SPIx = SPI1,
+		.CS_GPIOx = GPIOA,
+		.CS_PINx = GPIO_Pin_4,
+		.chain_len = CHAIN_LEN,
+		.stride = STRIDE, // only the first CHAIN_LEN bytes of a row are sent
+	};
+
+	max2719_init(&inst);
+
+	// byte = digit << 4 | module
+	uint8_t data[8 * STRIDE];
+	for (uint32_t d = 0; d < 8; d++) {
+		for (uint32_t m = 0; m < STRIDE; m++) {
+			data[d * STRIDE + m] = (uint8_t)((d << 4) | m);
+		}
+	}
+
+	test_build(&inst, data);
+	test_send(&inst, data);
+	test_busy(&inst, data);
+
+	if (failures) {
+		printf("%u check(s) failed\n", (unsigned)failures);
+		return 1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
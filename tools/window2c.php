@@ -0,0 +1,44 @@
+#!/usr/bin/env php
+<?php
+
+// Generate the window tables (project/window.c)
+//
+// Usage: window2c.php > project/window.c
+//
+// The tables hold the first half (+ the middle point) of periodic
+// windows of WINDOW_LEN points, as q15. A window of a shorter power
+// of 2 length is read with a stride, see spectrum_input_q15().
+
+const WINDOW_LEN = 2048;
+
+// name => [enum, cosine terms a0, a1, a2]
+$windows = [
+	'hann' => ['WINDOW_HANN', 0.5, 0.5, 0],
+	'hamming' => ['WINDOW_HAMMING', 0.54, 0.46, 0],
+	'blackman' => ['WINDOW_BLACKMAN', 0.42, 0.5, 0.08],
+];
+
+echo "// Generated by tools/window2c.php - do not edit\n\n";
+echo "#include \"window.h\"\n\n";
+
+foreach ($windows as $name => list($enum, $a0, $a1, $a2)) {
+	echo "static const q15_t $name" . "[WINDOW_LEN / 2 + 1] = {";
+
+	for ($i = 0; $i <= WINDOW_LEN / 2; $i++) {
+		$x = 2 * M_PI * $i / WINDOW_LEN;
+		$w = $a0 - $a1 * cos($x) + $a2 * cos(2 * $x);
+
+		echo ($i % 12 == 0) ? "\n\t" : " ";
+		echo (int) floor($w * 32767 + 0.5) . ",";
+	}
+
+	echo "\n};\n\n";
+}
+
+echo "const Window_Info windows[WINDOW_COUNT] = {\n";
+echo "\t[WINDOW_RECT] = { \"rect\", NULL, 4096 },\n";
+foreach ($windows as $name => list($enum, $a0)) {
+	// the coherent gain of a periodic cosine-sum window is a0
+	echo "\t[$enum] = { \"$name\", $name, " . (int) floor(4096 / $a0 + 0.5) . " },\n";
+}
+echo "};\n";